@@ -5,32 +5,175 @@
 #include <concepts>
 #include <numeric>
 #include <cassert>
+#include <tuple>
+#include <optional>
+#include <limits>
+#include <string>
+#include <cstdint>
+#include <bit>
+#include <ranges>
+#include <barrier>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <Parallel.hpp>
 
 namespace CLRS
 {
 
-// maximum subarray problem : find a subarray (of an array) that has the biggest summation
-// dp[i] represent the maximum subarray summation that ends with input[i]
-// time complexity: O(N)
-// space complexity: O(N)
+// maximum subarray problem : find a non-empty subarray (of an array) that has the biggest summation
+// Kadane's algorithm: the maximum subarray ending at input[i] is input[i] itself, or extends the one ending at input[i-1],
+// only the last one is needed, so it's kept in one variable instead of a dp array.
+// return the range [begin, end) of the subarray and its summation, the one that ends first if there are several,
+// and the shortest one of them (the latest begin).
+// time complexity: O(N), single pass
+// space complexity: O(1)
+template<std::forward_iterator ForwardIterator>
+std::tuple<ForwardIterator, ForwardIterator, typename std::iterator_traits<ForwardIterator>::value_type> maximumSubArrayRange(ForwardIterator first, ForwardIterator last)
+{
+    using value_type = typename std::iterator_traits<ForwardIterator>::value_type;
+    if (first == last)
+    {
+        return {first, last, value_type{}};
+    }
+    ForwardIterator bestBegin = first, curBegin = first;
+    value_type current = *first;
+    value_type result = current;
+    ForwardIterator bestEnd = ++first;
+    for (; first != last; ++first)
+    {
+        if (current > value_type{}) // extend the maximum subarray ending at previous element
+        {
+            current = current + *first;
+        }
+        else
+        {
+            current = *first;
+            curBegin = first;
+        }
+        if (result < current)
+        {
+            result = current;
+            bestBegin = curBegin;
+            bestEnd = std::next(first);
+        }
+    }
+    return {bestBegin, bestEnd, result};
+}
+
+template<std::forward_iterator ForwardIterator>
+typename std::iterator_traits<ForwardIterator>::value_type maximumSubArray(ForwardIterator first, ForwardIterator last)
+{
+    return std::get<2>(maximumSubArrayRange(first, last));
+}
+
+// parallel maximum subarray : every thread reduces a chunk to (total, best prefix, best suffix, best subarray),
+// the summaries of adjacent chunks combine associatively:
+//      total = L.total + R.total
+//      prefix = max(L.prefix, L.total + R.prefix)
+//      suffix = max(R.suffix, L.suffix + R.total)
+//      best = max(L.best, R.best, L.suffix + R.prefix)
+// ties are broken as maximumSubArrayRange does, so the result does not depend on threadCount:
+// prefixes and subarrays that end first, suffixes and subarrays that begin last.
+// time complexity: O(N/P + P)
+// space complexity: O(P)
+namespace Impl
+{
+template<typename T>
+struct SubArraySummary
+{
+    T total;
+    T prefix;               // sum of [begin, prefixEnd)
+    std::size_t prefixEnd;
+    T suffix;               // sum of [suffixBegin, end)
+    std::size_t suffixBegin;
+    T best;                 // sum of [bestBegin, bestEnd)
+    std::size_t bestBegin;
+    std::size_t bestEnd;
+};
+
+// summary of non-empty [first + begin, first + end), positions are indexes relative to first
 template<std::random_access_iterator RandomIterator>
-typename std::iterator_traits<RandomIterator>::value_type maximumSubArray(RandomIterator first, RandomIterator last)
+auto summarizeSubArray(RandomIterator first, std::size_t begin, std::size_t end)
 {
     using value_type = typename std::iterator_traits<RandomIterator>::value_type;
-    if (first >= last)
+    auto [bestFirst, bestLast, best] = maximumSubArrayRange(first + begin, first + end);
+    SubArraySummary<value_type> res{first[begin], first[begin], begin + 1, value_type{}, begin, best,
+        static_cast<std::size_t>(bestFirst - first), static_cast<std::size_t>(bestLast - first)};
+    value_type minPrefix{}; // minimum sum of [begin, i) for i in [begin, end), the last one, the suffix is total minus it
+    for (std::size_t i = begin + 1; i < end; ++i)
     {
-        return value_type{};
+        if (!(minPrefix < res.total))
+        {
+            minPrefix = res.total;
+            res.suffixBegin = i;
+        }
+        res.total = res.total + first[i];
+        if (res.prefix < res.total)
+        {
+            res.prefix = res.total;
+            res.prefixEnd = i + 1;
+        }
     }
+    res.suffix = res.total - minPrefix;
+    return res;
+}
+
+template<typename T>
+SubArraySummary<T> combineSubArraySummary(const SubArraySummary<T>& l, const SubArraySummary<T>& r)
+{
+    SubArraySummary<T> res = l;
+    res.total = l.total + r.total;
+    if (l.prefix < l.total + r.prefix)
+    {
+        res.prefix = l.total + r.prefix;
+        res.prefixEnd = r.prefixEnd;
+    }
+    res.suffix = r.suffix;
+    res.suffixBegin = r.suffixBegin;
+    if (r.suffix < l.suffix + r.total)
+    {
+        res.suffix = l.suffix + r.total;
+        res.suffixBegin = l.suffixBegin;
+    }
+    if (res.best < l.suffix + r.prefix)
+    {
+        res.best = l.suffix + r.prefix;
+        res.bestBegin = l.suffixBegin;
+        res.bestEnd = r.prefixEnd;
+    }
+    if (res.best < r.best || (!(r.best < res.best) && r.bestEnd <= res.bestEnd)) // equal: the crossing one ends no earlier
+    {
+        res.best = r.best;
+        res.bestBegin = r.bestBegin;
+        res.bestEnd = r.bestEnd;
+    }
+    return res;
+}
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator>
+std::tuple<RandomIterator, RandomIterator, typename std::iterator_traits<RandomIterator>::value_type>
+    parallelMaximumSubArrayRange(RandomIterator first, RandomIterator last, std::size_t threadCount = Impl::defaultThreadCount())
+{
+    constexpr std::size_t minChunkSize = 1 << 14;
     std::size_t N = last - first;
-    std::vector<value_type> dp(N);
-    dp[0] = *first;
-    value_type result = *first;
-    for (std::size_t i = 2; i < N; ++i)
+    threadCount = std::max<std::size_t>(1, std::min(threadCount, N / minChunkSize));
+    if (threadCount == 1)
+    {
+        return maximumSubArrayRange(first, last);
+    }
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    std::vector<std::optional<Impl::SubArraySummary<value_type>>> summaries(threadCount);
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        summaries[t] = Impl::summarizeSubArray(first, begin, end);
+    });
+    auto res = *summaries[0];
+    for (std::size_t t = 1; t < threadCount; ++t)
     {
-        dp[i] = std::max(first[i], first[i] + dp[i-1]);
-        result = std::max(result, dp[i]);
+        res = Impl::combineSubArraySummary(res, *summaries[t]);
     }
-    return result;
+    return {first + res.bestBegin, first + res.bestEnd, res.best};
 }
 
 // minimum calculation times of matrix chain order
@@ -72,23 +215,524 @@ auto minimumMatrixChainOrder(RandomIterator first, RandomIterator last)
     }
     return std::make_pair(std::move(m), std::move(s));
 }
-// for minimum matrix chain order problem
-template<std::integral T>
-std::string optimalMatrixChainOrderAsString(const std::vector<std::vector<T>>& s, std::size_t i, std::size_t j)
+// upper triangular N*N table packed in one contiguous buffer row by row, t[i][j] is valid for i <= j < N.
+// t[i] is a pointer to the row that could be indexed by j directly, so it's used like vector<vector<T>>.
+template<typename T>
+class TriangularTable
 {
-    std::ostringstream oss;
-    if (i == j)
+public:
+    TriangularTable(std::size_t n = 0) : m_size(n), m_data(n * (n + 1) / 2)
     {
-        oss << "A" << i;
     }
-    else
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    T* operator[](std::size_t i)
+    {
+        return m_data.data() + rowOffset(i);
+    }
+    const T* operator[](std::size_t i) const
+    {
+        return m_data.data() + rowOffset(i);
+    }
+private:
+    // start of row i is i*N - i*(i-1)/2, minus i for indexing by j
+    std::size_t rowOffset(std::size_t i) const
+    {
+        return i * m_size - i * (i + 1) / 2;
+    }
+    std::size_t m_size;
+    std::vector<T> m_data;
+};
+
+// parallel minimum calculation times of matrix chain order, same input and result as minimumMatrixChainOrder
+// - m and s are triangular tables packed in contiguous buffers, a transposed copy of m keeps every column contiguous,
+//   so both m[i][k] and m[k+1][j] of the inner loop over k are read with unit stride.
+// - cells of the same chain length (an anti-diagonal) only depend on shorter chains, they are computed by threadCount
+//   threads concurrently, diagonals are processed one after another (wavefront).
+//   threads are started once and wait for each other at a barrier after every diagonal, short diagonals are computed by one thread.
+// time complexity: O(N^3/P)
+// space complexity: O(N^2), about 3/2 N^2 values instead of 2 N^2
+template<std::random_access_iterator RandomIterator> requires std::integral<typename std::iterator_traits<RandomIterator>::value_type>
+auto parallelMinimumMatrixChainOrder(RandomIterator first, RandomIterator last, std::size_t threadCount = Impl::defaultThreadCount())
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    constexpr std::size_t minParallelWork = 1 << 16; // inner loop iterations of a diagonal worth splitting among threads
+    std::size_t N = last - first - 1; // number of matrices
+    std::vector<value_type> p(first, last);
+    TriangularTable<value_type> m(N);
+    TriangularTable<value_type> s(N);
+    std::vector<value_type> mt(N * (N + 1) / 2); // column j of m starts at j*(j+1)/2, mt[j*(j+1)/2 + i] = m[i][j]
+    auto computeCells = [&](std::size_t len, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            std::size_t j = i + len - 1;
+            const value_type* row = m[i];
+            value_type* column = mt.data() + j * (j + 1) / 2;
+            value_type pij = p[i] * p[j+1];
+            value_type best = std::numeric_limits<value_type>::max();
+            std::size_t split = i;
+            for (std::size_t k = i; k < j; ++k)
+            {
+                auto val = row[k] + column[k+1] + pij * p[k+1];
+                if (val < best)
+                {
+                    best = val;
+                    split = k;
+                }
+            }
+            m[i][j] = best;
+            s[i][j] = static_cast<value_type>(split);
+            column[i] = best;
+        }
+    };
+    // a diagonal takes at most about N^2/4 inner loop iterations
+    threadCount = N * N / 4 >= minParallelWork ? std::clamp<std::size_t>(threadCount, 1, N) : 1;
+    std::barrier sync(static_cast<std::ptrdiff_t>(threadCount));
+    Impl::parallelRun(threadCount, [&](std::size_t t) {
+        for (std::size_t len = 2; len <= N; ++len)
+        {
+            std::size_t cells = N - len + 1;
+            if (cells * len >= minParallelWork)
+                computeCells(len, cells * t / threadCount, cells * (t + 1) / threadCount);
+            else if (t == 0)
+                computeCells(len, 0, cells);
+            sync.arrive_and_wait();
+        }
+    });
+    return std::make_pair(std::move(m), std::move(s));
+}
+
+// splits of one optimal matrix chain order: s[i][j] is the split of Ai..Aj for the sub-chains of that order only,
+// it takes O(N) space instead of a N*N table and is used like the tables by optimalMatrixChainOrderAsString.
+class MatrixChainSplits
+{
+public:
+    class Row
+    {
+    public:
+        Row(const MatrixChainSplits& splits, std::size_t i) : m_splits(splits), m_i(i)
+        {
+        }
+        std::size_t operator[](std::size_t j) const
+        {
+            return m_splits.split(m_i, j);
+        }
+    private:
+        const MatrixChainSplits& m_splits;
+        std::size_t m_i;
+    };
+    MatrixChainSplits(std::size_t n = 0) : m_size(n), m_offsets(n + 1)
+    {
+    }
+    // splits are {i, j, k} triples
+    MatrixChainSplits(std::size_t n, std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> splits) : MatrixChainSplits(n)
+    {
+        std::sort(splits.begin(), splits.end());
+        for (auto [i, j, k] : splits)
+        {
+            ++m_offsets[i+1];
+            m_entries.emplace_back(j, k);
+        }
+        std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    Row operator[](std::size_t i) const
+    {
+        return Row(*this, i);
+    }
+    // split of Ai..Aj, Ai..Aj must be a sub-chain of the order
+    std::size_t split(std::size_t i, std::size_t j) const
+    {
+        auto first = m_entries.begin() + m_offsets[i], last = m_entries.begin() + m_offsets[i+1];
+        auto iter = std::lower_bound(first, last, std::make_pair(j, std::size_t(0)));
+        assert(iter != last && iter->first == j);
+        return iter->second;
+    }
+private:
+    std::size_t m_size;
+    std::vector<std::size_t> m_offsets; // entries of sub-chains starting at Ai are m_entries[m_offsets[i], m_offsets[i+1])
+    std::vector<std::pair<std::size_t, std::size_t>> m_entries; // {j, k} sorted by j
+};
+
+namespace Impl
+{
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 HuShingWide; // products of costs are compared exactly
+#else
+typedef long double HuShingWide;
+#endif
+
+// minimum cost of a polygon as a function of the weight w of one of its vertices (the apex): every partition costs
+// alpha*w + beta, so it's the lower envelope of lines, a concave piecewise linear function. a function is kept as
+// its right most line and a max heap (leftist heap, merged in O(logN)) of breakpoints, passing breakpoint b = e/d
+// to the left increases the slope by d and decreases the intercept by e, so all numbers are exact integers.
+class HuShingEnvelopes
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    struct Function
+    {
+        std::size_t heap;
+        long long alpha;
+        long long beta;
+    };
+    static Function line(long long alpha, long long beta)
+    {
+        return Function{npos, alpha, beta};
+    }
+    Function add(const Function& f, const Function& g)
+    {
+        return Function{merge(f.heap, g.heap), f.alpha + g.alpha, f.beta + g.beta};
+    }
+    // value at w, f is only evaluated at w or lower weights later, so the breakpoints from w on are dropped
+    long long valueAt(Function& f, long long w)
+    {
+        while (f.heap != npos && HuShingWide(m_nodes[f.heap].e) >= HuShingWide(w) * m_nodes[f.heap].d)
+        {
+            pop(f);
+        }
+        return f.alpha * w + f.beta;
+    }
+    // f = min(f, alpha*w + beta) where f - line is increasing, the line is taken from their crossing s on,
+    // return s as {d, e}, s = e/d
+    std::pair<long long, long long> minWithLine(Function& f, long long alpha, long long beta)
+    {
+        while (f.heap != npos)
+        {
+            const Node& top = m_nodes[f.heap];
+            if (HuShingWide(f.alpha - alpha) * top.e + HuShingWide(f.beta - beta) * top.d <= 0)
+            {
+                break;
+            }
+            pop(f);
+        }
+        long long d = f.alpha - alpha, e = beta - f.beta;
+        assert(d > 0);
+        if (e > 0)
+        {
+            m_nodes.push_back(Node{d, e, npos, npos, 1});
+            f.heap = merge(f.heap, m_nodes.size() - 1);
+        }
+        f.alpha = alpha;
+        f.beta = beta;
+        return {d, e};
+    }
+private:
+    struct Node
+    {
+        long long d;
+        long long e;
+        std::size_t left;
+        std::size_t right;
+        std::size_t rank;
+    };
+    std::size_t rank(std::size_t x) const
+    {
+        return x == npos ? 0 : m_nodes[x].rank;
+    }
+    std::size_t merge(std::size_t x, std::size_t y)
+    {
+        if (x == npos || y == npos)
+        {
+            return x == npos ? y : x;
+        }
+        if (HuShingWide(m_nodes[x].e) * m_nodes[y].d < HuShingWide(m_nodes[y].e) * m_nodes[x].d)
+        {
+            std::swap(x, y);
+        }
+        std::size_t right = merge(m_nodes[x].right, y); // depth is O(logN), right paths are short
+        Node& node = m_nodes[x];
+        node.right = right;
+        if (rank(node.left) < rank(node.right))
+        {
+            std::swap(node.left, node.right);
+        }
+        node.rank = rank(node.right) + 1;
+        return x;
+    }
+    void pop(Function& f)
     {
-        oss << "(";
-        oss << optimalMatrixChainOrderAsString(s, i, s[i][j]);
-        oss << optimalMatrixChainOrderAsString(s, s[i][j]+1, j);
-        oss << ")";
+        const Node& top = m_nodes[f.heap];
+        f.alpha += top.d;
+        f.beta -= top.e;
+        f.heap = merge(top.left, top.right);
     }
-    return oss.str();
+    std::vector<Node> m_nodes;
+};
+} // namespace Impl
+
+// minimum calculation times of matrix chain order by Hu-Shing polygon partitioning, for huge chains.
+// the dimensions p[0..N] are the weights of the vertices of a convex polygon, an order of the product is a partition
+// of the polygon into triangles, and a triangle costs the product of its weights, so it's the minimum partition cost.
+// - with V1 < V2 < V3 the lightest vertices, some optimal partition contains V1-V2 and V1-V3, and if V2, V3 are
+//   the neighbours of V1, it contains either V2-V3 or V1-V4. so the lightest vertex V1 is the apex of a fan, and the
+//   remaining chain splits at its lightest vertices (a cartesian tree) into chains whose ends are lighter than
+//   the vertices between them, each one is either closed by the arc between its ends or split again by the apex.
+// - the choice only depends on the weight of the apex, the cost of a chain is computed as a function of that weight
+//   for all apexes at once, from the leaves of the cartesian tree to the root: the sum of its two halves or the line
+//   of the arc, whichever is lower, with breakpoints in mergeable heaps. the choices are replayed from the root.
+// return the minimum cost and the splits of the order, costs must fit in long long.
+// time complexity: O(NlogN)
+// space complexity: O(N)
+template<std::random_access_iterator RandomIterator> requires std::integral<typename std::iterator_traits<RandomIterator>::value_type>
+std::pair<long long, MatrixChainSplits> huShingMatrixChainOrder(RandomIterator first, RandomIterator last)
+{
+    constexpr std::size_t npos = Impl::HuShingEnvelopes::npos;
+    std::size_t N = last - first - 1; // number of matrices
+    if (N < 2)
+    {
+        return {0, MatrixChainSplits(N)};
+    }
+    // vertices are rotated to make the lightest one the vertex 0, ties are broken by the rotated positions
+    std::size_t V = N + 1;
+    std::size_t start = std::min_element(first, last) - first;
+    std::vector<long long> w(V);
+    for (std::size_t v = 0; v < V; ++v)
+    {
+        w[v] = static_cast<long long>(first[(start + v) % V]);
+    }
+    auto lighter = [&](std::size_t x, std::size_t y) { return w[x] < w[y] || (w[x] == w[y] && x < y); };
+    // cartesian tree of vertices 1..V-1, node t stands for the chain between a[t] and b[t] split at t,
+    // nodes on the left and right paths from the root (a[t] == 0 or b[t] == V) are the vertices connected to vertex 0
+    std::vector<std::size_t> left(V, npos), right(V, npos), a(V), b(V), order;
+    order.reserve(V);
+    for (std::size_t v = 1; v < V; ++v)
+    {
+        std::size_t child = npos;
+        while (!order.empty() && lighter(v, order.back()))
+        {
+            child = order.back();
+            order.pop_back();
+        }
+        left[v] = child;
+        if (!order.empty())
+        {
+            right[order.back()] = v;
+        }
+        order.push_back(v);
+    }
+    std::size_t root = order.front();
+    order.assign(1, root);
+    a[root] = 0;
+    b[root] = V;
+    for (std::size_t idx = 0; idx < order.size(); ++idx) // pre-order
+    {
+        std::size_t t = order[idx];
+        if (left[t] != npos)
+        {
+            a[left[t]] = a[t];
+            b[left[t]] = t;
+            order.push_back(left[t]);
+        }
+        if (right[t] != npos)
+        {
+            a[right[t]] = t;
+            b[right[t]] = b[t];
+            order.push_back(right[t]);
+        }
+    }
+    auto onPath = [&](std::size_t t) { return a[t] == 0 || b[t] == V; };
+    // G[t] : cost of the polygon of chain t and an apex lighter than its ends, as a function of the apex weight
+    // H[t] : cost of the polygon of chain t closed by the arc between its ends
+    // s[t] : the arc is taken for apex weights from s[t] = e/d on
+    Impl::HuShingEnvelopes envelopes;
+    std::vector<Impl::HuShingEnvelopes::Function> G(V);
+    std::vector<long long> H(V);
+    std::vector<std::pair<long long, long long>> s(V);
+    auto halfFunction = [&](std::size_t child, std::size_t x, std::size_t y) {
+        return child != npos ? G[child] : Impl::HuShingEnvelopes::line(w[x] * w[y], 0); // a triangle with the apex
+    };
+    for (std::size_t idx = V - 1; idx-- > 0;) // children before parents
+    {
+        std::size_t t = order[idx];
+        if (onPath(t))
+        {
+            continue;
+        }
+        auto gl = halfFunction(left[t], a[t], t);
+        auto gr = halfFunction(right[t], t, b[t]);
+        long long hl = left[t] != npos ? H[left[t]] : 0;
+        long long hr = right[t] != npos ? H[right[t]] : 0;
+        if (lighter(a[t], b[t])) // closed polygon of the chain has apex a[t] and splits at t
+        {
+            envelopes.valueAt(gl, w[a[t]]);
+            H[t] = hl + envelopes.valueAt(gr, w[a[t]]);
+        }
+        else
+        {
+            envelopes.valueAt(gr, w[b[t]]);
+            H[t] = envelopes.valueAt(gl, w[b[t]]) + hr;
+        }
+        G[t] = envelopes.add(gl, gr);
+        s[t] = envelopes.minWithLine(G[t], w[a[t]] * w[b[t]], H[t]);
+    }
+    // the chain 1..V-1 with apex 0 splits at the nodes on the paths from the root
+    long long cost = 0;
+    std::vector<std::size_t> chains; // non-trivial chains of apex 0
+    for (std::size_t p = root; right[p] != npos; p = right[p])
+    {
+        std::size_t q = right[p];
+        cost += left[q] != npos ? envelopes.valueAt(G[left[q]], w[0]) : w[0] * w[p] * w[q];
+        if (left[q] != npos)
+        {
+            chains.push_back(left[q]);
+        }
+    }
+    for (std::size_t p = root; left[p] != npos; p = left[p])
+    {
+        std::size_t q = left[p];
+        cost += right[q] != npos ? envelopes.valueAt(G[right[q]], w[0]) : w[0] * w[q] * w[p];
+        if (right[q] != npos)
+        {
+            chains.push_back(right[q]);
+        }
+    }
+    // replay the choices to collect the arcs of the partition (rotated vertices)
+    std::vector<std::pair<std::size_t, std::size_t>> arcs;
+    for (std::size_t t : order)
+    {
+        if (onPath(t) && t != 1 && t != V - 1)
+        {
+            arcs.emplace_back(0, t);
+        }
+    }
+    struct Task
+    {
+        std::size_t t;
+        std::size_t apex; // npos for the closed polygon
+    };
+    std::vector<Task> tasks;
+    for (std::size_t t : chains)
+    {
+        tasks.push_back(Task{t, 0});
+    }
+    auto pushTask = [&](std::size_t t, std::size_t apex) {
+        if (t != npos)
+        {
+            tasks.push_back(Task{t, apex});
+        }
+    };
+    while (!tasks.empty())
+    {
+        auto [t, apex] = tasks.back();
+        tasks.pop_back();
+        if (apex != npos && Impl::HuShingWide(w[apex]) * s[t].first < s[t].second)
+        {
+            arcs.emplace_back(apex, t);
+            pushTask(left[t], apex);
+            pushTask(right[t], apex);
+            continue;
+        }
+        if (apex != npos)
+        {
+            arcs.emplace_back(a[t], b[t]);
+        }
+        if (lighter(a[t], b[t]))
+        {
+            if (left[t] != npos)
+            {
+                arcs.emplace_back(a[t], t);
+            }
+            pushTask(left[t], npos);
+            pushTask(right[t], a[t]);
+        }
+        else
+        {
+            if (right[t] != npos)
+            {
+                arcs.emplace_back(t, b[t]);
+            }
+            pushTask(left[t], b[t]);
+            pushTask(right[t], npos);
+        }
+    }
+    // Ai..Aj is the side p[i]-p[j+1], its triangle is closed by the last neighbour of p[i] before p[j+1]
+    std::vector<std::size_t> offsets(V + 1), neighbours;
+    for (auto& [x, y] : arcs)
+    {
+        x = (x + start) % V;
+        y = (y + start) % V;
+        if (x > y)
+        {
+            std::swap(x, y);
+        }
+        ++offsets[x+1];
+    }
+    for (std::size_t v = 0; v + 1 < V; ++v)
+    {
+        ++offsets[v+1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    neighbours.resize(offsets[V]);
+    std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t v = 0; v + 1 < V; ++v)
+    {
+        neighbours[fill[v]++] = v + 1;
+    }
+    for (auto [x, y] : arcs)
+    {
+        neighbours[fill[x]++] = y;
+    }
+    for (std::size_t v = 0; v < V; ++v)
+    {
+        std::sort(neighbours.begin() + offsets[v], neighbours.begin() + offsets[v+1]);
+    }
+    std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> splits;
+    splits.reserve(N - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, N - 1}};
+    while (!stack.empty())
+    {
+        auto [i, j] = stack.back();
+        stack.pop_back();
+        if (i == j)
+        {
+            continue;
+        }
+        auto firstNeighbour = neighbours.begin() + offsets[i], lastNeighbour = neighbours.begin() + offsets[i+1];
+        std::size_t k = *(std::lower_bound(firstNeighbour, lastNeighbour, j + 1) - 1) - 1;
+        splits.emplace_back(i, j, k);
+        stack.emplace_back(i, k);
+        stack.emplace_back(k + 1, j);
+    }
+    return {cost, MatrixChainSplits(N, std::move(splits))};
+}
+
+// for minimum matrix chain order problem, s is the table of splits: vector<vector<T>>, TriangularTable<T> or MatrixChainSplits
+// iterative with an explicit stack, so the depth of the order is not limited by the call stack.
+template<typename Table>
+std::string optimalMatrixChainOrderAsString(const Table& s, std::size_t i, std::size_t j)
+{
+    constexpr std::size_t closing = static_cast<std::size_t>(-1);
+    std::string res;
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{i, j}}; // {closing, closing} for a ")"
+    while (!stack.empty())
+    {
+        auto [first, last] = stack.back();
+        stack.pop_back();
+        if (first == closing)
+        {
+            res += ")";
+        }
+        else if (first == last)
+        {
+            res += "A";
+            res += std::to_string(first);
+        }
+        else
+        {
+            std::size_t k = static_cast<std::size_t>(s[first][last]);
+            res += "(";
+            stack.emplace_back(closing, closing);
+            stack.emplace_back(k + 1, last);
+            stack.emplace_back(first, k);
+        }
+    }
+    return res;
 }
 
 // longest common subsequence (LCS) problem
@@ -147,7 +791,87 @@ auto LCS(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty,
     }
     return std::make_pair(std::move(c), std::move(b));
 }
+// tiled wavefront parallel LCS, same input and result (c and b) as LCS, LCSResultToSubsequence works on the result.
+// the tables are split into tileSize*tileSize tiles, a tile only depends on its upper, left and upper-left tiles,
+// so the tiles of an anti-diagonal are computed concurrently, threads are started once and meet at a barrier
+// after every anti-diagonal. rows of a tile are walked through row pointers, the previous row stays in cache.
+// time complexity: O(xlen*ylen/P)
+// space complexity: O(xlen*ylen)
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2>
+auto parallelLCS(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty, RandomIterator2 lasty,
+    std::size_t threadCount = Impl::defaultThreadCount(), std::size_t tileSize = 256)
+{
+    using value_type = typename std::iterator_traits<RandomIterator1>::value_type;
+    using value_type2 = typename std::iterator_traits<RandomIterator2>::value_type;
+    static_assert(std::convertible_to<value_type2, value_type>);
+    std::size_t xlen = lastx - firstx;
+    std::size_t ylen = lasty - firsty;
+    // rows are allocated and zeroed concurrently too, page faults of large tables take as long as the computation
+    std::vector<std::vector<int>> b(xlen+1);
+    std::vector<std::vector<std::size_t>> c(xlen+1);
+    Impl::parallelFor(xlen + 1, threadCount, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            b[i].assign(ylen + 1, 0);
+            c[i].assign(ylen + 1, 0);
+        }
+    });
+    tileSize = std::max<std::size_t>(1, tileSize);
+    std::size_t rowTiles = (xlen + tileSize - 1) / tileSize;
+    std::size_t columnTiles = (ylen + tileSize - 1) / tileSize;
+    if (rowTiles == 0 || columnTiles == 0)
+    {
+        return std::make_pair(std::move(c), std::move(b));
+    }
+    // rows and columns of tile (ti, tj) are [ti*tileSize+1, (ti+1)*tileSize] and [tj*tileSize+1, (tj+1)*tileSize]
+    auto computeTile = [&](std::size_t ti, std::size_t tj) {
+        std::size_t jfirst = tj * tileSize + 1, jlast = std::min(ylen, (tj + 1) * tileSize);
+        for (std::size_t i = ti * tileSize + 1; i <= std::min(xlen, (ti + 1) * tileSize); ++i)
+        {
+            const auto& xi = firstx[i-1];
+            const std::size_t* prev = c[i-1].data();
+            std::size_t* row = c[i].data();
+            int* brow = b[i].data();
+            for (std::size_t j = jfirst; j <= jlast; ++j)
+            {
+                if (xi == firsty[j-1])
+                {
+                    row[j] = prev[j-1] + 1;
+                    brow[j] = 0;
+                }
+                else if (prev[j] > row[j-1])
+                {
+                    row[j] = prev[j];
+                    brow[j] = 1;
+                }
+                else
+                {
+                    row[j] = row[j-1];
+                    brow[j] = -1;
+                }
+            }
+        }
+    };
+    threadCount = std::clamp<std::size_t>(threadCount, 1, std::min(rowTiles, columnTiles));
+    std::barrier sync(static_cast<std::ptrdiff_t>(threadCount));
+    Impl::parallelRun(threadCount, [&](std::size_t t) {
+        for (std::size_t d = 0; d + 1 < rowTiles + columnTiles; ++d)
+        {
+            // tiles (ti, d-ti) of the anti-diagonal are dealt round robin
+            std::size_t tiFirst = d < columnTiles ? 0 : d - columnTiles + 1;
+            std::size_t tiLast = std::min(d, rowTiles - 1);
+            for (std::size_t ti = tiFirst + t; ti <= tiLast; ti += threadCount)
+            {
+                computeTile(ti, d - ti);
+            }
+            sync.arrive_and_wait();
+        }
+    });
+    return std::make_pair(std::move(c), std::move(b));
+}
+
 // get subsequence from LCS function result
+// the path is walked back from (i, j) iteratively, the indexes of matched elements are buffered to output them in order.
 template<std::random_access_iterator RandomIterator, std::output_iterator<typename std::iterator_traits<RandomIterator>::value_type> OutputIterator>
 void LCSResultToSubsequence(RandomIterator firstx, RandomIterator lastx, const std::vector<std::vector<int>>& b, OutputIterator outIter, std::size_t i, std::size_t j)
 {
@@ -156,23 +880,727 @@ void LCSResultToSubsequence(RandomIterator firstx, RandomIterator lastx, const s
     assert(i <= xlen);
     assert(i < b.size());
     assert(j < b[0].size());
-    if (i == 0 || j == 0)
+    std::vector<std::size_t> matched;
+    while (i != 0 && j != 0)
+    {
+        if (b[i][j] == 0) // xi == yj
+        {
+            matched.push_back(i-1);
+            --i;
+            --j;
+        }
+        else if (b[i][j] == 1) // Xi-1 & Yj
+        {
+            --i;
+        }
+        else // Xi & Yj-1
+        {
+            --j;
+        }
+    }
+    for (auto iter = matched.rbegin(); iter != matched.rend(); ++iter)
+    {
+        *outIter++ = firstx[*iter];
+    }
+}
+
+namespace Impl
+{
+// last row of the LCS length table c of X and Y by two rolling rows, row[j] = c[xlen][j], prev is the buffer of the other row.
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2>
+void LCSLastRow(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty, RandomIterator2 lasty,
+    std::vector<std::size_t>& row, std::vector<std::size_t>& prev)
+{
+    std::size_t ylen = lasty - firsty;
+    row.assign(ylen + 1, 0);
+    prev.assign(ylen + 1, 0);
+    for (; firstx != lastx; ++firstx)
     {
+        std::swap(row, prev);
+        const auto& xi = *firstx;
+        for (std::size_t j = 1; j <= ylen; ++j)
+        {
+            row[j] = xi == firsty[j-1] ? prev[j-1] + 1 : std::max(prev[j], row[j-1]);
+        }
+    }
+}
+
+// Hirschberg's algorithm on A and the shorter B, emit(i, j) is called for matched A[i] == B[j] in order.
+// sub-problems are kept in an explicit stack, left one on top, so the matches are found from left to right.
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Emit>
+std::size_t hirschbergLCS(RandomIterator1 firstA, RandomIterator1 lastA, RandomIterator2 firstB, RandomIterator2 lastB, Emit emit)
+{
+    struct Range
+    {
+        std::size_t a0, a1, b0, b1;
+    };
+    std::vector<Range> stack{{0, static_cast<std::size_t>(lastA - firstA), 0, static_cast<std::size_t>(lastB - firstB)}};
+    std::vector<std::size_t> forward, backward, buffer;
+    std::size_t length = 0;
+    while (!stack.empty())
+    {
+        auto [a0, a1, b0, b1] = stack.back();
+        stack.pop_back();
+        if (a0 == a1 || b0 == b1)
+        {
+            continue;
+        }
+        if (a1 - a0 == 1 || b1 - b0 == 1) // one match at most
+        {
+            for (std::size_t i = a0; i < a1; ++i)
+            {
+                for (std::size_t j = b0; j < b1; ++j)
+                {
+                    if (firstA[i] == firstB[j])
+                    {
+                        emit(i, j);
+                        ++length;
+                        i = a1;
+                        break;
+                    }
+                }
+            }
+            continue;
+        }
+        // split A in the middle, B where the LCS of the upper half and a prefix of B plus the LCS of the lower half
+        // and the remaining suffix of B is maximum, computed forward and backward (on reversed sequences)
+        std::size_t mid = a0 + (a1 - a0) / 2;
+        LCSLastRow(firstA + a0, firstA + mid, firstB + b0, firstB + b1, forward, buffer);
+        LCSLastRow(std::make_reverse_iterator(firstA + a1), std::make_reverse_iterator(firstA + mid),
+            std::make_reverse_iterator(firstB + b1), std::make_reverse_iterator(firstB + b0), backward, buffer);
+        std::size_t nb = b1 - b0, k = 0;
+        for (std::size_t j = 1; j <= nb; ++j)
+        {
+            if (forward[j] + backward[nb-j] > forward[k] + backward[nb-k])
+            {
+                k = j;
+            }
+        }
+        stack.push_back(Range{mid, a1, b0 + k, b1});
+        stack.push_back(Range{a0, mid, b0, b0 + k});
+    }
+    return length;
+}
+} // namespace Impl
+
+// linear space LCS by Hirschberg's algorithm: the LCS is split at the middle row of the table c, where it crosses
+// at a column k that maximizes the LCS lengths of the upper-left and lower-right parts, each one is computed by two rolling rows,
+// the two parts are solved in the same way, only the rows of the current part are kept.
+// the subsequence is written to outIter in order, return its length.
+// time complexity: O(xlen*ylen)
+// space complexity: O(min(xlen,ylen))
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2,
+    std::output_iterator<typename std::iterator_traits<RandomIterator1>::value_type> OutputIterator>
+std::size_t hirschbergLCS(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty, RandomIterator2 lasty, OutputIterator outIter)
+{
+    if (lastx - firstx >= lasty - firsty)
+    {
+        return Impl::hirschbergLCS(firstx, lastx, firsty, lasty, [&](std::size_t i, std::size_t) { *outIter++ = firstx[i]; });
+    }
+    return Impl::hirschbergLCS(firsty, lasty, firstx, lastx, [&](std::size_t, std::size_t j) { *outIter++ = firstx[j]; });
+}
+
+// length of LCS only, by two rolling rows of the shorter sequence.
+// time complexity: O(xlen*ylen)
+// space complexity: O(min(xlen,ylen))
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2>
+std::size_t LCSLength(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty, RandomIterator2 lasty)
+{
+    std::vector<std::size_t> row, prev;
+    if (lastx - firstx >= lasty - firsty)
+    {
+        Impl::LCSLastRow(firstx, lastx, firsty, lasty, row, prev);
+    }
+    else
+    {
+        Impl::LCSLastRow(firsty, lasty, firstx, lastx, row, prev);
+    }
+    return row.back();
+}
+
+namespace Impl
+{
+template<typename T>
+concept LCSByte = std::integral<T> && sizeof(T) == 1;
+
+// match vectors of a byte sequence (pattern) for bit-parallel LCS: bit i of word k of row c is set if pattern[64k+i] == c,
+// the extra row 256 is all zero, it's used for texts that have ended in a batch.
+class LCSMatchVectors
+{
+public:
+    static constexpr std::size_t zeroRow = 256;
+    template<std::random_access_iterator RandomIterator>
+    LCSMatchVectors(RandomIterator first, RandomIterator last)
+        : m_size(last - first), m_words((m_size + 63) / 64), m_masks((zeroRow + 1) * m_words)
+    {
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            m_masks[static_cast<unsigned char>(first[i]) * m_words + i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    std::size_t words() const
+    {
+        return m_words;
+    }
+    const std::uint64_t* data() const
+    {
+        return m_masks.data();
+    }
+    const std::uint64_t* row(std::size_t c) const
+    {
+        return m_masks.data() + c * m_words;
+    }
+    // V has a zero bit for every matched pattern element, each text element c updates it by
+    // V = (V + (V & M[c])) | (V & ~M[c]), the addition carries from word to word.
+    template<std::random_access_iterator RandomIterator>
+    std::size_t LCSLength(RandomIterator first, RandomIterator last, std::vector<std::uint64_t>& v) const
+    {
+        if (m_words == 1) // the common short pattern, V is kept in a register
+        {
+            std::uint64_t v0 = ~std::uint64_t(0);
+            for (; first != last; ++first)
+            {
+                std::uint64_t match = m_masks[static_cast<unsigned char>(*first)];
+                v0 = (v0 + (v0 & match)) | (v0 & ~match);
+            }
+            return zeros(&v0, 1);
+        }
+        v.assign(m_words, ~std::uint64_t(0));
+        for (; first != last; ++first)
+        {
+            const std::uint64_t* match = row(static_cast<unsigned char>(*first));
+            std::uint64_t carry = 0;
+            for (std::size_t k = 0; k < m_words; ++k)
+            {
+                std::uint64_t u = v[k] & match[k];
+                std::uint64_t sum = v[k] + u;
+                std::uint64_t carryOut = sum < u;
+                sum += carry;
+                carry = carryOut | (sum < carry);
+                v[k] = sum | (v[k] & ~match[k]);
+            }
+        }
+        return zeros(v.data(), 1);
+    }
+    // zero bits of V in the pattern, the LCS length
+    std::size_t zeros(const std::uint64_t* v, std::size_t stride) const
+    {
+        std::size_t ones = 0;
+        for (std::size_t k = 0; k < m_words; ++k)
+        {
+            std::uint64_t word = v[k * stride];
+            if (k + 1 == m_words && m_size % 64 != 0)
+            {
+                word &= (std::uint64_t(1) << (m_size % 64)) - 1;
+            }
+            ones += std::popcount(word);
+        }
+        return m_size - ones;
+    }
+private:
+    std::size_t m_size;
+    std::size_t m_words;
+    std::vector<std::uint64_t> m_masks;
+};
+
+#if defined(__AVX2__)
+// 4 texts in the 4 lanes, rows[4j+lane] is the offset of the match vectors of the j-th element of the text in the lane,
+// v[4k+lane] is word k of V of the lane. unsigned carries are detected by signed comparisons with flipped sign bits.
+inline void LCSStepsAvx2(const LCSMatchVectors& pattern, const long long* rows, std::size_t steps, std::uint64_t* v)
+{
+    const long long* masks = reinterpret_cast<const long long*>(pattern.data());
+    const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t words = pattern.words();
+    if (words == 1) // V is kept in a register, no carries
+    {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v));
+        for (std::size_t j = 0; j < steps; ++j)
+        {
+            __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + 4 * j));
+            __m256i match = _mm256_i64gather_epi64(masks, offsets, 8);
+            v0 = _mm256_or_si256(_mm256_add_epi64(v0, _mm256_and_si256(v0, match)), _mm256_andnot_si256(match, v0));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(v), v0);
         return;
     }
-    if (b[i][j] == 0) // xi == yj
+    for (std::size_t j = 0; j < steps; ++j)
+    {
+        __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + 4 * j));
+        __m256i carry = zero; // 0 or all ones
+        for (std::size_t k = 0; k < words; ++k)
+        {
+            __m256i match = _mm256_i64gather_epi64(masks + k, offsets, 8);
+            __m256i vk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + 4 * k));
+            __m256i u = _mm256_and_si256(vk, match);
+            __m256i sum = _mm256_add_epi64(vk, u);
+            __m256i carryOut = _mm256_cmpgt_epi64(_mm256_xor_si256(u, sign), _mm256_xor_si256(sum, sign)); // sum < u
+            sum = _mm256_sub_epi64(sum, carry);
+            carry = _mm256_or_si256(carryOut, _mm256_and_si256(carry, _mm256_cmpeq_epi64(sum, zero)));
+            vk = _mm256_or_si256(sum, _mm256_andnot_si256(match, vk));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + 4 * k), vk);
+        }
+    }
+}
+#endif
+} // namespace Impl
+
+// bit-parallel LCS length of byte sequences (Allison-Dix, Hyyro): a column of the LCS length table of the shorter
+// sequence (pattern) and a prefix of the other one (text) is encoded by its increments in bits, one bit per pattern
+// element, and a whole column is computed from the previous one by a few word operations per 64 pattern elements.
+// time complexity: O(xlen*ylen/w), w = 64
+// space complexity: O(256*min(xlen,ylen)/w)
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2>
+    requires Impl::LCSByte<std::iter_value_t<RandomIterator1>> && Impl::LCSByte<std::iter_value_t<RandomIterator2>>
+std::size_t bitParallelLCSLength(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty, RandomIterator2 lasty)
+{
+    std::vector<std::uint64_t> v;
+    if (lastx - firstx <= lasty - firsty)
+    {
+        return Impl::LCSMatchVectors(firstx, lastx).LCSLength(firsty, lasty, v);
+    }
+    return Impl::LCSMatchVectors(firsty, lasty).LCSLength(firstx, lastx, v);
+}
+
+// bit-parallel LCS lengths of one query against many candidates (ranges of bytes), written to outIter in order.
+// the match vectors of the query are computed once, with AVX2 4 candidates are processed at once in the 4 lanes.
+// time complexity: O(qlen*(total length of candidates)/w), w = 64
+// space complexity: O(256*qlen/w)
+template<std::random_access_iterator RandomIterator, std::forward_iterator ForwardIterator, std::output_iterator<std::size_t> OutputIterator>
+    requires Impl::LCSByte<std::iter_value_t<RandomIterator>> && std::ranges::random_access_range<std::iter_reference_t<ForwardIterator>>
+        && Impl::LCSByte<std::ranges::range_value_t<std::iter_reference_t<ForwardIterator>>>
+OutputIterator bitParallelLCSLengths(RandomIterator firstq, RandomIterator lastq, ForwardIterator first, ForwardIterator last, OutputIterator outIter)
+{
+    Impl::LCSMatchVectors pattern(firstq, lastq);
+    std::vector<std::uint64_t> v;
+#if defined(__AVX2__)
+    constexpr std::size_t lanes = 4;
+    std::vector<long long> rows;
+    while (first != last)
+    {
+        ForwardIterator group[lanes];
+        std::size_t count = 0, steps = 0;
+        for (; count < lanes && first != last; ++count, ++first)
+        {
+            group[count] = first;
+            steps = std::max<std::size_t>(steps, std::ranges::distance(*first));
+        }
+        // ended texts and missing lanes match nothing, that keeps V unchanged
+        rows.assign(lanes * steps, static_cast<long long>(Impl::LCSMatchVectors::zeroRow * pattern.words()));
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            auto&& text = *group[lane];
+            auto textFirst = std::ranges::begin(text);
+            std::size_t length = std::ranges::distance(text);
+            for (std::size_t j = 0; j < length; ++j)
+            {
+                rows[lanes * j + lane] = static_cast<long long>(static_cast<unsigned char>(textFirst[j]) * pattern.words());
+            }
+        }
+        v.assign(lanes * pattern.words(), ~std::uint64_t(0));
+        Impl::LCSStepsAvx2(pattern, rows.data(), steps, v.data());
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            *outIter++ = pattern.zeros(v.data() + lane, lanes);
+        }
+    }
+#else
+    for (; first != last; ++first)
+    {
+        auto&& text = *first;
+        *outIter++ = pattern.LCSLength(std::ranges::begin(text), std::ranges::end(text), v);
+    }
+#endif
+    return outIter;
+}
+
+// edit script of a diff: x is turned into y by its hunks in order, xpos and ypos are where a hunk starts in x and y,
+// keep: x[xpos, xpos+length) == y[ypos, ypos+length), erase: x[xpos, xpos+length) is removed,
+// insert: y[ypos, ypos+length) is inserted. between two keep hunks, erased elements come before inserted ones.
+enum class EditOperation
+{
+    keep,
+    erase,
+    insert
+};
+struct EditHunk
+{
+    EditOperation operation;
+    std::size_t xpos;
+    std::size_t ypos;
+    std::size_t length;
+    friend bool operator==(const EditHunk&, const EditHunk&) = default;
+};
+
+namespace Impl
+{
+// split point (x, y) of a middle snake of a[0, N) and b[0, M), and the edit distance D
+struct MyersSplit
+{
+    std::size_t x;
+    std::size_t y;
+    std::size_t cost;
+};
+
+// Myers' linear space search: furthest reaching D-paths from the start (v1) and from the end (v2, on reversed sequences)
+// are extended by one edit at a time until they overlap on a diagonal, the overlap is on an optimal path.
+// paths that leave the grid stop their diagonals (kStart, kEnd). a and b are non-empty, differ in their first and
+// last elements. step d rules out costs below 2d-1, so no split is returned if maxCost is reached.
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2>
+std::optional<MyersSplit> myersSplit(RandomIterator1 a, std::ptrdiff_t N, RandomIterator2 b, std::ptrdiff_t M, std::size_t maxCost,
+    std::vector<std::ptrdiff_t>& v1, std::vector<std::ptrdiff_t>& v2)
+{
+    std::ptrdiff_t maxD = (N + M + 1) / 2;
+    std::ptrdiff_t steps = maxCost >= static_cast<std::size_t>(N + M) ? maxD : std::min<std::ptrdiff_t>(maxD, static_cast<std::ptrdiff_t>((maxCost + 1) / 2 + 1));
+    std::ptrdiff_t offset = steps, length = 2 * steps + 2;
+    v1.assign(length, -1);
+    v2.assign(length, -1);
+    v1[offset+1] = 0;
+    v2[offset+1] = 0;
+    std::ptrdiff_t delta = N - M;
+    bool front = delta % 2 != 0; // overlaps are found by the forward paths if delta is odd, by the reverse ones otherwise
+    std::ptrdiff_t k1Start = 0, k1End = 0, k2Start = 0, k2End = 0;
+    for (std::ptrdiff_t d = 0; d < steps; ++d)
+    {
+        for (std::ptrdiff_t k1 = -d + k1Start; k1 <= d - k1End; k1 += 2)
+        {
+            std::ptrdiff_t k1Offset = offset + k1;
+            std::ptrdiff_t x1 = (k1 == -d || (k1 != d && v1[k1Offset-1] < v1[k1Offset+1])) ? v1[k1Offset+1] : v1[k1Offset-1] + 1;
+            std::ptrdiff_t y1 = x1 - k1;
+            while (x1 < N && y1 < M && a[x1] == b[y1])
+            {
+                ++x1;
+                ++y1;
+            }
+            v1[k1Offset] = x1;
+            if (x1 > N)
+            {
+                k1End += 2;
+            }
+            else if (y1 > M)
+            {
+                k1Start += 2;
+            }
+            else if (front)
+            {
+                std::ptrdiff_t k2Offset = offset + delta - k1;
+                if (k2Offset >= 0 && k2Offset < length && v2[k2Offset] != -1 && x1 >= N - v2[k2Offset])
+                {
+                    return MyersSplit{static_cast<std::size_t>(x1), static_cast<std::size_t>(y1), static_cast<std::size_t>(2 * d - 1)};
+                }
+            }
+        }
+        for (std::ptrdiff_t k2 = -d + k2Start; k2 <= d - k2End; k2 += 2)
+        {
+            std::ptrdiff_t k2Offset = offset + k2;
+            std::ptrdiff_t x2 = (k2 == -d || (k2 != d && v2[k2Offset-1] < v2[k2Offset+1])) ? v2[k2Offset+1] : v2[k2Offset-1] + 1;
+            std::ptrdiff_t y2 = x2 - k2;
+            while (x2 < N && y2 < M && a[N-x2-1] == b[M-y2-1])
+            {
+                ++x2;
+                ++y2;
+            }
+            v2[k2Offset] = x2;
+            if (x2 > N)
+            {
+                k2End += 2;
+            }
+            else if (y2 > M)
+            {
+                k2Start += 2;
+            }
+            else if (!front)
+            {
+                std::ptrdiff_t k1Offset = offset + delta - k2;
+                if (k1Offset >= 0 && k1Offset < length && v1[k1Offset] != -1 && v1[k1Offset] >= N - x2)
+                {
+                    std::ptrdiff_t x1 = v1[k1Offset];
+                    return MyersSplit{static_cast<std::size_t>(x1), static_cast<std::size_t>(x1 - (delta - k2)), static_cast<std::size_t>(2 * d)};
+                }
+            }
+        }
+    }
+    if (steps < maxD)
     {
-        LCSResultToSubsequence(firstx, lastx, b, outIter, i-1, j-1);
-        *outIter++ = firstx[i-1];
+        return std::nullopt;
     }
-    else if (b[i][j] == 1) // Xi-1 & Yj
+    // nothing in common, erase all and insert all
+    return MyersSplit{static_cast<std::size_t>(N), 0, static_cast<std::size_t>(N + M)};
+}
+
+// merges the edits found from left to right into hunks
+template<typename OutputIterator>
+class EditHunkWriter
+{
+public:
+    EditHunkWriter(OutputIterator outIter) : m_outIter(outIter)
     {
-        LCSResultToSubsequence(firstx, lastx, b, outIter, i-1, j);
     }
-    else // Xi & Yj-1
+    void keep(std::size_t x, std::size_t y, std::size_t length)
     {
-        LCSResultToSubsequence(firstx, lastx, b, outIter, i, j-1);
+        if (length == 0)
+        {
+            return;
+        }
+        flushChanges();
+        if (m_keep.length != 0 && m_keep.xpos + m_keep.length != x)
+        {
+            flushKeep();
+        }
+        if (m_keep.length == 0)
+        {
+            m_keep = EditHunk{EditOperation::keep, x, y, 0};
+        }
+        m_keep.length += length;
+    }
+    void erase(std::size_t x, std::size_t y, std::size_t length)
+    {
+        change(m_erase, EditOperation::erase, x, y, length);
+    }
+    void insert(std::size_t x, std::size_t y, std::size_t length)
+    {
+        change(m_insert, EditOperation::insert, x, y, length);
+    }
+    OutputIterator finish()
+    {
+        flushKeep();
+        flushChanges();
+        return m_outIter;
+    }
+private:
+    void change(EditHunk& hunk, EditOperation operation, std::size_t x, std::size_t y, std::size_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        flushKeep();
+        if (m_erase.length == 0 && m_insert.length == 0)
+        {
+            m_gapX = x;
+            m_gapY = y;
+        }
+        if (hunk.length == 0)
+        {
+            hunk = EditHunk{operation, 0, 0, 0};
+        }
+        hunk.length += length;
+    }
+    void flushKeep()
+    {
+        if (m_keep.length != 0)
+        {
+            *m_outIter++ = m_keep;
+            m_keep.length = 0;
+        }
+    }
+    void flushChanges()
+    {
+        if (m_erase.length != 0)
+        {
+            *m_outIter++ = EditHunk{EditOperation::erase, m_gapX, m_gapY, m_erase.length};
+        }
+        if (m_insert.length != 0)
+        {
+            *m_outIter++ = EditHunk{EditOperation::insert, m_gapX + m_erase.length, m_gapY, m_insert.length};
+        }
+        m_erase.length = 0;
+        m_insert.length = 0;
+    }
+    OutputIterator m_outIter;
+    EditHunk m_keep{EditOperation::keep, 0, 0, 0};
+    EditHunk m_erase{EditOperation::erase, 0, 0, 0};
+    EditHunk m_insert{EditOperation::insert, 0, 0, 0};
+    std::size_t m_gapX = 0; // where the erased and inserted elements between two keep hunks start
+    std::size_t m_gapY = 0;
+};
+} // namespace Impl
+
+// Myers' O((N+M)D) diff: the edit script of the minimum number D of erased and inserted elements, that is
+// xlen + ylen - 2*LCS, written to outIter as EditHunk in order, and D is returned.
+// - common prefixes and suffixes are kept directly, so near-identical inputs take near-linear time.
+// - linear space refinement: the middle snake of an optimal path splits the problem into two smaller ones,
+//   which are kept in an explicit stack (left one on top) instead of recursion.
+// - if D exceeds maxCost, the search stops after O((N+M)*maxCost), nothing is written and nullopt is returned.
+// time complexity: O((xlen+ylen)*D)
+// space complexity: O(xlen+ylen)
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, std::output_iterator<EditHunk> OutputIterator>
+std::optional<std::size_t> myersDiff(RandomIterator1 firstx, RandomIterator1 lastx, RandomIterator2 firsty, RandomIterator2 lasty,
+    OutputIterator outIter, std::size_t maxCost = std::numeric_limits<std::size_t>::max())
+{
+    struct Task
+    {
+        std::size_t x0, x1, y0, y1;
+        bool kept; // x[x0, x1) == y[y0, y1) is kept
+    };
+    std::vector<std::ptrdiff_t> v1, v2;
+    std::vector<Task> stack;
+    Impl::EditHunkWriter<OutputIterator> writer(outIter);
+    // trim the common prefix and suffix, return the prefix length and push the suffix
+    auto trim = [&](Task& task) {
+        std::size_t prefix = 0;
+        while (task.x0 + prefix < task.x1 && task.y0 + prefix < task.y1 && firstx[task.x0 + prefix] == firsty[task.y0 + prefix])
+        {
+            ++prefix;
+        }
+        task.x0 += prefix;
+        task.y0 += prefix;
+        std::size_t suffix = 0;
+        while (task.x0 < task.x1 - suffix && task.y0 < task.y1 - suffix && firstx[task.x1 - suffix - 1] == firsty[task.y1 - suffix - 1])
+        {
+            ++suffix;
+        }
+        if (suffix != 0)
+        {
+            stack.push_back(Task{task.x1 - suffix, task.x1, task.y1 - suffix, task.y1, true});
+        }
+        task.x1 -= suffix;
+        task.y1 -= suffix;
+        return prefix;
+    };
+    auto split = [&](const Task& task, std::size_t limit) {
+        return Impl::myersSplit(firstx + task.x0, static_cast<std::ptrdiff_t>(task.x1 - task.x0),
+            firsty + task.y0, static_cast<std::ptrdiff_t>(task.y1 - task.y0), limit, v1, v2);
+    };
+    auto pushHalves = [&](const Task& task, const Impl::MyersSplit& middle) {
+        stack.push_back(Task{task.x0 + middle.x, task.x1, task.y0 + middle.y, task.y1, false});
+        stack.push_back(Task{task.x0, task.x0 + middle.x, task.y0, task.y0 + middle.y, false});
+    };
+    // the first split also gives D, it's checked against maxCost before anything is written
+    Task task{0, static_cast<std::size_t>(lastx - firstx), 0, static_cast<std::size_t>(lasty - firsty), false};
+    std::size_t prefix = trim(task);
+    std::optional<Impl::MyersSplit> middle;
+    std::size_t cost = (task.x1 - task.x0) + (task.y1 - task.y0);
+    if (task.x0 != task.x1 && task.y0 != task.y1)
+    {
+        middle = split(task, maxCost);
+        if (!middle)
+        {
+            return std::nullopt;
+        }
+        cost = middle->cost;
+    }
+    if (cost > maxCost)
+    {
+        return std::nullopt;
+    }
+    writer.keep(0, 0, prefix);
+    if (middle)
+    {
+        pushHalves(task, *middle);
+    }
+    else
+    {
+        stack.push_back(task);
+    }
+    while (!stack.empty())
+    {
+        task = stack.back();
+        stack.pop_back();
+        if (task.kept)
+        {
+            writer.keep(task.x0, task.y0, task.x1 - task.x0);
+            continue;
+        }
+        prefix = trim(task);
+        writer.keep(task.x0 - prefix, task.y0 - prefix, prefix);
+        if (task.x0 == task.x1 || task.y0 == task.y1)
+        {
+            writer.erase(task.x0, task.y0, task.x1 - task.x0);
+            writer.insert(task.x0, task.y0, task.y1 - task.y0);
+            continue;
+        }
+        pushHalves(task, *split(task, std::numeric_limits<std::size_t>::max()));
+    }
+    writer.finish();
+    return cost;
+}
+
+// optimal binary search tree: keys k0 < k1 < ... < kn-1 are searched with probabilities p[0..n), searches between
+// the keys (dummy keys d0, ..., dn, di is between ki-1 and ki) with probabilities q[0..n], frequencies work as well.
+// keys are 0-based, the tree of keys ki..kj-1 has dummy keys di..dj, for 0 <= i <= j <= n:
+// e[i][j] = q[i],                                                  if i == j
+//         = min{e[i][r] + e[r+1][j] + w(i,j)} for i <= r < j,      if i < j
+// w(i,j) = p[i] + ... + p[j-1] + q[i] + ... + q[j] from prefix sums, root[i][j] is the best r,
+// e[0][n] is the expected search cost (nodes visited) of the optimal tree.
+// Knuth's speedup: root[i][j-1] <= root[i][j] <= root[i+1][j], the ranges of r of the trees of one size sum up to O(n).
+// e and root are triangular tables of size n+1.
+// time complexity: O(n^2)
+// space complexity: O(n^2)
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2>
+auto optimalBST(RandomIterator1 firstp, RandomIterator1 lastp, RandomIterator2 firstq, [[maybe_unused]] RandomIterator2 lastq)
+{
+    using value_type = std::common_type_t<std::iter_value_t<RandomIterator1>, std::iter_value_t<RandomIterator2>>;
+    std::size_t n = lastp - firstp;
+    assert(static_cast<std::size_t>(lastq - firstq) == n + 1);
+    std::vector<value_type> sump(n + 1), sumq(n + 2); // prefix sums
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        sump[i+1] = sump[i] + firstp[i];
+    }
+    for (std::size_t i = 0; i <= n; ++i)
+    {
+        sumq[i+1] = sumq[i] + firstq[i];
+    }
+    TriangularTable<value_type> e(n + 1);
+    TriangularTable<std::size_t> root(n + 1);
+    for (std::size_t i = 0; i <= n; ++i)
+    {
+        e[i][i] = firstq[i];
+    }
+    for (std::size_t len = 1; len <= n; ++len)
+    {
+        for (std::size_t i = 0; i + len <= n; ++i)
+        {
+            std::size_t j = i + len;
+            std::size_t first = len == 1 ? i : root[i][j-1];
+            std::size_t last = len == 1 ? i : root[i+1][j];
+            value_type best = e[i][first] + e[first+1][j];
+            std::size_t bestRoot = first;
+            for (std::size_t r = first + 1; r <= last; ++r)
+            {
+                value_type val = e[i][r] + e[r+1][j];
+                if (val < best)
+                {
+                    best = val;
+                    bestRoot = r;
+                }
+            }
+            e[i][j] = best + (sump[j] - sump[i]) + (sumq[j+1] - sumq[i]);
+            root[i][j] = bestRoot;
+        }
+    }
+    return std::make_pair(std::move(e), std::move(root));
+}
+
+// construct the optimal binary search tree of sorted keys from the root table of optimalBST, Tree is a CLRS::BsTree.
+// keys are inserted in preorder, every parent before its children, so a plain binary search tree takes exactly the
+// optimal shape (balanced trees would rebalance it).
+// time complexity: O(n*h), h is the height of the tree
+// space complexity: O(h)
+template<typename Tree, std::random_access_iterator RandomIterator, typename Table>
+Tree optimalBSTToTree(RandomIterator firstKey, RandomIterator lastKey, const Table& root)
+{
+    Tree tree;
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, static_cast<std::size_t>(lastKey - firstKey)}}; // keys ki..kj-1
+    while (!stack.empty())
+    {
+        auto [i, j] = stack.back();
+        stack.pop_back();
+        if (i == j)
+        {
+            continue;
+        }
+        std::size_t r = root[i][j];
+        tree.insert(firstKey[r]);
+        stack.emplace_back(r + 1, j);
+        stack.emplace_back(i, r);
     }
+    return tree;
 }
 
 } // namespace CLRS
@@ -0,0 +1,369 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <compare>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CLRS
+{
+
+// instrumentation : count comparisons, copies, moves and allocations done by algorithms and containers
+// - BasicCountingCompare<Compare> wraps a comparator and counts its calls.
+// - BasicInstrumented<T> wraps a value and counts its copies, moves and comparisons by operators,
+//   arithmetic operators are forwarded to the wrapped values.
+// - BasicCountingAllocator<T> counts allocations of a container (std::vector, ...).
+// - heap allocations of the whole program (nodes of BsTree, buffers of sorting algorithms, ...) are counted
+//   if CLRS_INSTRUMENTATION_REPLACE_NEW is defined before including this header in exactly one translation unit,
+//   which replaces the global operator new and operator delete.
+// CountingCompare, Instrumented and CountingAllocator are aliases of the wrappers if CLRS_INSTRUMENTATION is defined,
+// or aliases of the wrapped types otherwise, so the instrumentation compiles away to nothing when it is disabled.
+// counters are global relaxed atomics shared by all threads, read them by instrumentationStats().
+// note: wrapped values are not arithmetic types, so algorithms that require them (bucketSort, smallSort,
+// minimumMatrixChainOrder, ...) could not take them, and std::less/std::greater specific paths (sorting networks) are not taken.
+struct InstrumentationStats
+{
+    std::uint64_t comparisons = 0;
+    std::uint64_t copies = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    friend InstrumentationStats operator-(const InstrumentationStats& a, const InstrumentationStats& b)
+    {
+        return InstrumentationStats{a.comparisons - b.comparisons, a.copies - b.copies, a.moves - b.moves,
+            a.allocations - b.allocations, a.deallocations - b.deallocations, a.allocatedBytes - b.allocatedBytes};
+    }
+    friend bool operator==(const InstrumentationStats&, const InstrumentationStats&) = default;
+};
+
+namespace Impl
+{
+struct InstrumentationCounters
+{
+    std::atomic<std::uint64_t> comparisons = 0;
+    std::atomic<std::uint64_t> copies = 0;
+    std::atomic<std::uint64_t> moves = 0;
+    std::atomic<std::uint64_t> allocations = 0;
+    std::atomic<std::uint64_t> deallocations = 0;
+    std::atomic<std::uint64_t> allocatedBytes = 0;
+};
+inline InstrumentationCounters instrumentationCounters;
+
+inline void countOperation(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1)
+{
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+} // namespace Impl
+
+inline InstrumentationStats instrumentationStats()
+{
+    auto& c = Impl::instrumentationCounters;
+    return InstrumentationStats{c.comparisons.load(std::memory_order_relaxed), c.copies.load(std::memory_order_relaxed),
+        c.moves.load(std::memory_order_relaxed), c.allocations.load(std::memory_order_relaxed),
+        c.deallocations.load(std::memory_order_relaxed), c.allocatedBytes.load(std::memory_order_relaxed)};
+}
+
+inline void resetInstrumentationStats()
+{
+    auto& c = Impl::instrumentationCounters;
+    for (auto* counter : {&c.comparisons, &c.copies, &c.moves, &c.allocations, &c.deallocations, &c.allocatedBytes})
+        counter->store(0, std::memory_order_relaxed);
+}
+
+template<typename Compare = std::less<>>
+class BasicCountingCompare
+{
+public:
+    BasicCountingCompare(const Compare& comp = Compare()) : m_comp(comp)
+    {
+    }
+    template<typename T1, typename T2>
+    bool operator()(T1&& a, T2&& b) const
+    {
+        Impl::countOperation(Impl::instrumentationCounters.comparisons);
+        return std::invoke(m_comp, std::forward<T1>(a), std::forward<T2>(b));
+    }
+private:
+    Compare m_comp;
+};
+
+template<typename T>
+class BasicInstrumented
+{
+public:
+    T value{};
+    BasicInstrumented() = default;
+    BasicInstrumented(const T& _value) : value(_value)
+    {
+    }
+    BasicInstrumented(T&& _value) : value(std::move(_value))
+    {
+    }
+    BasicInstrumented(const BasicInstrumented& other) : value(other.value)
+    {
+        Impl::countOperation(Impl::instrumentationCounters.copies);
+    }
+    BasicInstrumented(BasicInstrumented&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : value(std::move(other.value))
+    {
+        Impl::countOperation(Impl::instrumentationCounters.moves);
+    }
+    BasicInstrumented& operator=(const BasicInstrumented& other)
+    {
+        value = other.value;
+        Impl::countOperation(Impl::instrumentationCounters.copies);
+        return *this;
+    }
+    BasicInstrumented& operator=(BasicInstrumented&& other) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        value = std::move(other.value);
+        Impl::countOperation(Impl::instrumentationCounters.moves);
+        return *this;
+    }
+    // comparisons
+    friend bool operator==(const BasicInstrumented& a, const BasicInstrumented& b)
+    {
+        Impl::countOperation(Impl::instrumentationCounters.comparisons);
+        return a.value == b.value;
+    }
+    friend auto operator<=>(const BasicInstrumented& a, const BasicInstrumented& b) requires std::three_way_comparable<T>
+    {
+        Impl::countOperation(Impl::instrumentationCounters.comparisons);
+        return a.value <=> b.value;
+    }
+    friend bool operator<(const BasicInstrumented& a, const BasicInstrumented& b)
+    {
+        Impl::countOperation(Impl::instrumentationCounters.comparisons);
+        return a.value < b.value;
+    }
+    friend bool operator>(const BasicInstrumented& a, const BasicInstrumented& b)
+    {
+        return b < a;
+    }
+    friend bool operator<=(const BasicInstrumented& a, const BasicInstrumented& b)
+    {
+        return !(b < a);
+    }
+    friend bool operator>=(const BasicInstrumented& a, const BasicInstrumented& b)
+    {
+        return !(a < b);
+    }
+    // arithmetic operations are forwarded to values
+    friend BasicInstrumented operator+(const BasicInstrumented& a, const BasicInstrumented& b) requires requires(const T& x) { x + x; }
+    {
+        return BasicInstrumented(a.value + b.value);
+    }
+    friend BasicInstrumented operator-(const BasicInstrumented& a, const BasicInstrumented& b) requires requires(const T& x) { x - x; }
+    {
+        return BasicInstrumented(a.value - b.value);
+    }
+    friend BasicInstrumented operator*(const BasicInstrumented& a, const BasicInstrumented& b) requires requires(const T& x) { x * x; }
+    {
+        return BasicInstrumented(a.value * b.value);
+    }
+    BasicInstrumented& operator+=(const BasicInstrumented& other) requires requires(T& x) { x += x; }
+    {
+        value += other.value;
+        return *this;
+    }
+    BasicInstrumented& operator-=(const BasicInstrumented& other) requires requires(T& x) { x -= x; }
+    {
+        value -= other.value;
+        return *this;
+    }
+    // container-like access for string sorting (msdRadixSort)
+    decltype(auto) operator[](std::size_t i) const requires requires(const T& v) { v[i]; }
+    {
+        return value[i];
+    }
+    auto size() const requires requires(const T& v) { v.size(); }
+    {
+        return value.size();
+    }
+    template<typename OStream>
+    friend OStream& operator<<(OStream& os, const BasicInstrumented& x) requires requires(OStream& s, const T& v) { s << v; }
+    {
+        os << x.value;
+        return os;
+    }
+};
+
+template<typename T>
+class BasicCountingAllocator
+{
+public:
+    using value_type = T;
+    BasicCountingAllocator() = default;
+    template<typename U>
+    BasicCountingAllocator(const BasicCountingAllocator<U>&)
+    {
+    }
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        Impl::countOperation(Impl::instrumentationCounters.allocations);
+        Impl::countOperation(Impl::instrumentationCounters.allocatedBytes, n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n)
+    {
+        Impl::countOperation(Impl::instrumentationCounters.deallocations);
+        std::allocator<T>().deallocate(p, n);
+    }
+    template<typename U>
+    friend bool operator==(const BasicCountingAllocator&, const BasicCountingAllocator<U>&)
+    {
+        return true;
+    }
+};
+
+#if defined(CLRS_INSTRUMENTATION)
+inline constexpr bool instrumentationEnabled = true;
+template<typename Compare = std::less<>>
+using CountingCompare = BasicCountingCompare<Compare>;
+template<typename T>
+using Instrumented = BasicInstrumented<T>;
+template<typename T>
+using CountingAllocator = BasicCountingAllocator<T>;
+#else
+inline constexpr bool instrumentationEnabled = false;
+template<typename Compare = std::less<>>
+using CountingCompare = Compare;
+template<typename T>
+using Instrumented = T;
+template<typename T>
+using CountingAllocator = std::allocator<T>;
+#endif
+
+} // namespace CLRS
+
+#if defined(CLRS_INSTRUMENTATION_REPLACE_NEW)
+#include <cstdlib>
+// replaced global allocation functions, every form of them is replaced so that news and deletes always match:
+// plain, array, nothrow, sized and over-aligned ones. over-aligned blocks are over-allocated by malloc,
+// the pointer returned by malloc is kept right before the aligned block.
+// malloc and free are kept out of line, or gcc warns about free of a pointer from operator new (-Wmismatched-new-delete).
+namespace CLRS::Impl
+{
+[[gnu::noinline]] inline void* countedAllocate(std::size_t size) noexcept
+{
+    countOperation(instrumentationCounters.allocations);
+    countOperation(instrumentationCounters.allocatedBytes, size);
+    return std::malloc(size ? size : 1);
+}
+[[gnu::noinline]] inline void countedDeallocate(void* p) noexcept
+{
+    if (p)
+    {
+        countOperation(instrumentationCounters.deallocations);
+        std::free(p);
+    }
+}
+[[gnu::noinline]] inline void* countedAlignedAllocate(std::size_t size, std::align_val_t alignment) noexcept
+{
+    countOperation(instrumentationCounters.allocations);
+    countOperation(instrumentationCounters.allocatedBytes, size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    void* raw = std::malloc(size + align + sizeof(void*));
+    if (!raw)
+        return nullptr;
+    std::uintptr_t address = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + align - 1) & ~(align - 1);
+    void* p = reinterpret_cast<void*>(address);
+    static_cast<void**>(p)[-1] = raw;
+    return p;
+}
+[[gnu::noinline]] inline void countedAlignedDeallocate(void* p) noexcept
+{
+    if (p)
+        countedDeallocate(static_cast<void**>(p)[-1]);
+}
+} // namespace CLRS::Impl
+
+void* operator new(std::size_t size)
+{
+    if (void* p = CLRS::Impl::countedAllocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CLRS::Impl::countedAllocate(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CLRS::Impl::countedAllocate(size);
+}
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = CLRS::Impl::countedAlignedAllocate(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CLRS::Impl::countedAlignedAllocate(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CLRS::Impl::countedAlignedAllocate(size, alignment);
+}
+void operator delete(void* p) noexcept
+{
+    CLRS::Impl::countedDeallocate(p);
+}
+void operator delete[](void* p) noexcept
+{
+    CLRS::Impl::countedDeallocate(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    CLRS::Impl::countedDeallocate(p);
+}
+void operator delete[](void* p, std::size_t) noexcept
+{
+    CLRS::Impl::countedDeallocate(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    CLRS::Impl::countedDeallocate(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    CLRS::Impl::countedDeallocate(p);
+}
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    CLRS::Impl::countedAlignedDeallocate(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    CLRS::Impl::countedAlignedDeallocate(p);
+}
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    CLRS::Impl::countedAlignedDeallocate(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    CLRS::Impl::countedAlignedDeallocate(p);
+}
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    CLRS::Impl::countedAlignedDeallocate(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    CLRS::Impl::countedAlignedDeallocate(p);
+}
+#endif
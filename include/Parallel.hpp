@@ -0,0 +1,57 @@
+#pragma once
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace CLRS
+{
+
+// small fork-join helpers shared by the parallel algorithms
+namespace Impl
+{
+// number of threads used by parallel algorithms when the caller does not specify one
+inline std::size_t defaultThreadCount()
+{
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// run func(threadIndex) for every threadIndex in [0, threadCount) concurrently and wait for all of them,
+// the calling thread runs threadIndex 0 itself.
+template<typename Function>
+void parallelRun(std::size_t threadCount, Function func)
+{
+    if (threadCount <= 1)
+    {
+        func(std::size_t(0));
+        return;
+    }
+    std::vector<std::jthread> threads;
+    threads.reserve(threadCount - 1);
+    for (std::size_t t = 1; t < threadCount; ++t)
+    {
+        threads.emplace_back([&func, t]() { func(t); });
+    }
+    func(std::size_t(0));
+} // jthreads join on destruction
+
+// split [0, N) into threadCount contiguous chunks, run func(threadIndex, begin, end) for every chunk concurrently
+template<typename Function>
+void parallelFor(std::size_t N, std::size_t threadCount, Function func)
+{
+    threadCount = std::max<std::size_t>(1, std::min(threadCount, N));
+    parallelRun(threadCount, [&](std::size_t t) {
+        func(t, N * t / threadCount, N * (t + 1) / threadCount);
+    });
+}
+
+// run two tasks concurrently and wait for both of them
+template<typename Function1, typename Function2>
+void parallelInvoke(Function1&& func1, Function2&& func2)
+{
+    std::jthread thread(std::forward<Function2>(func2));
+    func1();
+}
+} // namespace Impl
+
+} // namespace CLRS
@@ -2,6 +2,29 @@
 #include <iterator>
 #include <vector>
 #include <cassert>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <concepts>
+#include <functional>
+#include <numeric>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <ranges>
+#include <array>
+#include <utility>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <Parallel.hpp>
 
 namespace CLRS
 {
@@ -12,7 +35,7 @@ namespace CLRS
 template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
 void insertionSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
 {
-    assert(first < last);
+    assert(first <= last);
     if (first == last || first + 1 == last)
         return;
     for (auto iter = first + 1; iter != last; ++iter)
@@ -21,94 +44,2790 @@ void insertionSort(RandomIterator first, RandomIterator last, Compare comp = std
         auto iter2 = iter;
         for (; iter2 != first && comp(key, *(iter2-1)); --iter2)
         {
-            *iter2 = *(iter2-1);
+            *iter2 = std::move(*(iter2-1));
         }
         *iter2 = std::move(key);
     }
 }
 
+// small sort : sort at most 32 arithmetic values in ascending order with a sorting network
+// a sorting network is a fixed sequence of compare-exchange operations independent of data, so it runs without branch.
+// input is padded to 8/16/32 elements with the maximum value of the type, then sorted by:
+// - AVX2 bitonic networks in registers for 32-bit int and float when AVX2 is enabled (-mavx2 or -march=native),
+// - Batcher's odd-even merge sort network with branchless min/max for other types or without AVX2.
+// time complexity: O(1), 19/63/191 compare-exchanges for 8/16/32 elements
+// space complexity: O(1)
+namespace Impl
+{
+constexpr std::size_t smallSortMaxSize = 32;
+
+template<typename T>
+concept SortingNetworkValue = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+// whether sorting networks could be used for values of type T compared by Compare, ascending or descending
+template<typename T, typename Compare>
+constexpr bool sortingNetworkAscending = SortingNetworkValue<T> && (std::same_as<Compare, std::less<>> || std::same_as<Compare, std::less<T>>);
+template<typename T, typename Compare>
+constexpr bool sortingNetworkDescending = SortingNetworkValue<T> && (std::same_as<Compare, std::greater<>> || std::same_as<Compare, std::greater<T>>);
+
+// compare-exchange pairs of Batcher's odd-even merge sort network for N elements, N is a power of 2
+template<std::size_t N>
+constexpr auto oddEvenMergeNetwork()
+{
+    constexpr std::size_t logN = std::bit_width(N) - 1;
+    std::array<std::pair<unsigned char, unsigned char>, (logN * logN - logN + 4) * N / 4 - 1> pairs{};
+    std::size_t count = 0;
+    for (std::size_t p = 1; p < N; p <<= 1)
+    {
+        for (std::size_t k = p; k >= 1; k >>= 1)
+        {
+            for (std::size_t j = k % p; j + k < N; j += 2 * k)
+            {
+                for (std::size_t i = 0; i < std::min(k, N - j - k); ++i)
+                {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                    {
+                        pairs[count++] = {static_cast<unsigned char>(i + j), static_cast<unsigned char>(i + j + k)};
+                    }
+                }
+            }
+        }
+    }
+    return pairs;
+}
+
+template<std::size_t N, SortingNetworkValue T>
+void scalarSortingNetwork(T* data)
+{
+    static constexpr auto pairs = oddEvenMergeNetwork<N>();
+    for (auto [a, b] : pairs)
+    {
+        T x = data[a];
+        T y = data[b];
+        data[a] = y < x ? y : x;
+        data[b] = y < x ? x : y;
+    }
+}
+
+#if defined(__AVX2__)
+// operations on 8 lanes of 32-bit int or float
+template<typename T>
+struct Avx2Lanes;
+template<>
+struct Avx2Lanes<std::int32_t>
+{
+    using Vector = __m256i;
+    static Vector load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(std::int32_t* p, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vector min(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm256_max_epi32(a, b); }
+    static Vector permute(Vector v, __m256i index) { return _mm256_permutevar8x32_epi32(v, index); }
+    template<int Mask>
+    static Vector blend(Vector a, Vector b) { return _mm256_blend_epi32(a, b, Mask); }
+};
+template<>
+struct Avx2Lanes<float>
+{
+    using Vector = __m256;
+    static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+    static Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+    static Vector permute(Vector v, __m256i index) { return _mm256_permutevar8x32_ps(v, index); }
+    template<int Mask>
+    static Vector blend(Vector a, Vector b) { return _mm256_blend_ps(a, b, Mask); }
+};
+
+// one layer of bitonic network in a register: lane i is compared with lane i^J,
+// lanes of ascending blocks of size K keep the minimum at the lower lane.
+template<typename Lanes, int J, int K>
+typename Lanes::Vector bitonicLayer(typename Lanes::Vector v)
+{
+    constexpr int maxMask = []() {
+        int mask = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            bool ascending = (i & K) == 0;
+            if (ascending == (i > (i ^ J)))
+                mask |= 1 << i;
+        }
+        return mask;
+    }();
+    auto other = Lanes::permute(v, _mm256_setr_epi32(0 ^ J, 1 ^ J, 2 ^ J, 3 ^ J, 4 ^ J, 5 ^ J, 6 ^ J, 7 ^ J));
+    return Lanes::template blend<maxMask>(Lanes::min(v, other), Lanes::max(v, other));
+}
+
+// sort a bitonic sequence in a register
+template<typename Lanes>
+typename Lanes::Vector bitonicMerge8(typename Lanes::Vector v)
+{
+    v = bitonicLayer<Lanes, 4, 8>(v);
+    v = bitonicLayer<Lanes, 2, 8>(v);
+    return bitonicLayer<Lanes, 1, 8>(v);
+}
+
+template<typename Lanes>
+typename Lanes::Vector bitonicSort8(typename Lanes::Vector v)
+{
+    v = bitonicLayer<Lanes, 1, 2>(v);
+    v = bitonicLayer<Lanes, 2, 4>(v);
+    v = bitonicLayer<Lanes, 1, 4>(v);
+    return bitonicMerge8<Lanes>(v);
+}
+
+template<typename Lanes>
+typename Lanes::Vector reverse8(typename Lanes::Vector v)
+{
+    return Lanes::permute(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// merge sorted a and sorted b, a gets the smaller half
+template<typename Lanes>
+void bitonicMerge16(typename Lanes::Vector& a, typename Lanes::Vector& b)
+{
+    auto rb = reverse8<Lanes>(b);
+    auto lo = Lanes::min(a, rb);
+    auto hi = Lanes::max(a, rb);
+    a = bitonicMerge8<Lanes>(lo);
+    b = bitonicMerge8<Lanes>(hi);
+}
+
+template<std::size_t N, typename T>
+void avx2SortingNetwork(T* data)
+{
+    using Lanes = Avx2Lanes<T>;
+    if constexpr (N == 8)
+    {
+        Lanes::store(data, bitonicSort8<Lanes>(Lanes::load(data)));
+    }
+    else if constexpr (N == 16)
+    {
+        auto a = bitonicSort8<Lanes>(Lanes::load(data));
+        auto b = bitonicSort8<Lanes>(Lanes::load(data + 8));
+        bitonicMerge16<Lanes>(a, b);
+        Lanes::store(data, a);
+        Lanes::store(data + 8, b);
+    }
+    else
+    {
+        auto a = bitonicSort8<Lanes>(Lanes::load(data));
+        auto b = bitonicSort8<Lanes>(Lanes::load(data + 8));
+        auto c = bitonicSort8<Lanes>(Lanes::load(data + 16));
+        auto d = bitonicSort8<Lanes>(Lanes::load(data + 24));
+        bitonicMerge16<Lanes>(a, b);
+        bitonicMerge16<Lanes>(c, d);
+        // [a, b, reverse(d), reverse(c)] is bitonic, split it into two bitonic halves of 16
+        auto rd = reverse8<Lanes>(d);
+        auto rc = reverse8<Lanes>(c);
+        auto l1 = Lanes::min(a, rd), h1 = Lanes::max(a, rd);
+        auto l2 = Lanes::min(b, rc), h2 = Lanes::max(b, rc);
+        // half cleaner of every bitonic half, then merge every register
+        Lanes::store(data, bitonicMerge8<Lanes>(Lanes::min(l1, l2)));
+        Lanes::store(data + 8, bitonicMerge8<Lanes>(Lanes::max(l1, l2)));
+        Lanes::store(data + 16, bitonicMerge8<Lanes>(Lanes::min(h1, h2)));
+        Lanes::store(data + 24, bitonicMerge8<Lanes>(Lanes::max(h1, h2)));
+    }
+}
+#endif
+
+template<std::size_t N, SortingNetworkValue T>
+void sortingNetwork(T* data)
+{
+#if defined(__AVX2__)
+    if constexpr (std::same_as<T, std::int32_t> || std::same_as<T, float>)
+    {
+        avx2SortingNetwork<N>(data);
+        return;
+    }
+#endif
+    scalarSortingNetwork<N>(data);
+}
+
+// sort [first, last) of at most smallSortMaxSize elements by sorting network, in descending order if Descending
+template<bool Descending = false, std::random_access_iterator RandomIterator>
+void smallSortImpl(RandomIterator first, RandomIterator last)
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    std::size_t n = last - first;
+    assert(n <= smallSortMaxSize);
+    constexpr value_type padding = std::numeric_limits<value_type>::has_infinity ? std::numeric_limits<value_type>::infinity() : std::numeric_limits<value_type>::max();
+    value_type buffer[smallSortMaxSize];
+    std::copy(first, last, buffer);
+    std::size_t size = n <= 8 ? 8 : n <= 16 ? 16 : 32;
+    std::fill(buffer + n, buffer + size, padding);
+    if (size == 8)
+        sortingNetwork<8>(buffer);
+    else if (size == 16)
+        sortingNetwork<16>(buffer);
+    else
+        sortingNetwork<32>(buffer);
+    if constexpr (Descending)
+        std::reverse_copy(buffer, buffer + n, first);
+    else
+        std::copy(buffer, buffer + n, first);
+}
+
+// sort a small range by sorting network if it's possible, or by insertion sort otherwise
+template<std::random_access_iterator RandomIterator, typename Compare>
+void smallSortOrInsertionSort(RandomIterator first, RandomIterator last, Compare& comp)
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    if constexpr (sortingNetworkAscending<value_type, Compare>)
+        smallSortImpl<false>(first, last);
+    else if constexpr (sortingNetworkDescending<value_type, Compare>)
+        smallSortImpl<true>(first, last);
+    else
+        insertionSort(first, last, comp);
+}
+} // namespace Impl
+
+template<Impl::SortingNetworkValue T, std::size_t N> requires (N <= Impl::smallSortMaxSize)
+void smallSort(T (&arr)[N])
+{
+    Impl::smallSortImpl(arr, arr + N);
+}
+
+template<Impl::SortingNetworkValue T, std::size_t N> requires (N <= Impl::smallSortMaxSize)
+void smallSort(std::array<T, N>& arr)
+{
+    Impl::smallSortImpl(arr.begin(), arr.end());
+}
+
 // merge sort : a divide and conquer algorithm
 // time complexity: average O(NlogN)
 // space complexity: O(N)
 namespace Impl
 {
+// sort [sFirst, sLast), leave the result in [sFirst, sLast) if toDest is false, or in [dFirst, dFirst + (sLast - sFirst)) otherwise.
+// two halves are sorted into the other range, then merged into the target range,
+// so the source and destination are used as ping-pong buffers and no level copies its result back.
 template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Compare = std::less<>>
-void mergeSortImpl(RandomIterator1 sFirst, RandomIterator1 sLast, RandomIterator2 dFirst, Compare comp = std::less<>())
+void mergeSortImpl(RandomIterator1 sFirst, RandomIterator1 sLast, RandomIterator2 dFirst, bool toDest, Compare comp = std::less<>())
 {
-    assert(sFirst < sLast);
-    if (sLast - sFirst <= 1)
+    using value_type = typename std::iterator_traits<RandomIterator1>::value_type;
+    assert(sFirst <= sLast);
+    // small ranges are sorted in place, sorting networks are only used for integers since they are not stable,
+    // but equivalent integers are indistinguishable
+    constexpr std::ptrdiff_t baseSize = std::is_integral_v<value_type> && (sortingNetworkAscending<value_type, Compare> || sortingNetworkDescending<value_type, Compare>)
+        ? smallSortMaxSize : 16;
+    if (sLast - sFirst <= baseSize)
+    {
+        if constexpr (std::is_integral_v<value_type>)
+            smallSortOrInsertionSort(sFirst, sLast, comp);
+        else
+            insertionSort(sFirst, sLast, comp);
+        if (toDest)
+        {
+            std::move(sFirst, sLast, dFirst);
+        }
         return;
+    }
     std::size_t offset = (sLast - sFirst) / 2;
-    mergeSortImpl(sFirst, sFirst + offset, dFirst, comp);
-    mergeSortImpl(sFirst + offset, sLast, dFirst + offset, comp);
-    std::merge(std::make_move_iterator(sFirst), std::make_move_iterator(sFirst + offset),
-               std::make_move_iterator(sFirst + offset), std::make_move_iterator(sLast),
-               dFirst, comp);
-    std::move(dFirst, dFirst + (sLast - sFirst), sFirst);
+    mergeSortImpl(sFirst, sFirst + offset, dFirst, !toDest, comp);
+    mergeSortImpl(sFirst + offset, sLast, dFirst + offset, !toDest, comp);
+    if (toDest)
+    {
+        std::merge(std::make_move_iterator(sFirst), std::make_move_iterator(sFirst + offset),
+                   std::make_move_iterator(sFirst + offset), std::make_move_iterator(sLast),
+                   dFirst, comp);
+    }
+    else
+    {
+        auto dLast = dFirst + (sLast - sFirst);
+        std::merge(std::make_move_iterator(dFirst), std::make_move_iterator(dFirst + offset),
+                   std::make_move_iterator(dFirst + offset), std::make_move_iterator(dLast),
+                   sFirst, comp);
+    }
 }
 } // namespace Impl
 
 template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
 void mergeSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
 {
-    assert(first < last);
+    assert(first <= last);
     if (last - first <= 1)
         return;
     using value_type = std::iterator_traits<RandomIterator>::value_type;
     std::vector<value_type> tmpVec;
     tmpVec.reserve(last - first);
     std::move(first, last, std::back_inserter(tmpVec));
-    Impl::mergeSortImpl(tmpVec.begin(), tmpVec.end(), first, comp);
-    std::move(tmpVec.begin(), tmpVec.end(), first);
+    Impl::mergeSortImpl(tmpVec.begin(), tmpVec.end(), first, true, comp);
 }
 
-// heap sort
-// time complexity: O(NlogN)
-// space complexity: O(1), inplace sorting
-template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
-void heapSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+// parallel merge sort : fork-join merge sort, both the recursion and the merge step are split across threads
+// the merge of two sorted ranges is split into threadCount independent merges of equal output size,
+// the split points are found by co-rank binary search (merge path).
+// time complexity: O(NlogN/P + log^2(N)), P is thread count
+// space complexity: O(N), one buffer shared by all threads
+namespace Impl
+{
+// co-rank of output rank r for stable merge of A = [first1, first1 + n1) and B = [first2, first2 + n2):
+// return i such that the first r elements of the merged output are A[0, i) and B[0, r - i)
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Compare>
+std::size_t mergeCoRank(std::size_t r, RandomIterator1 first1, std::size_t n1, RandomIterator2 first2, std::size_t n2, Compare& comp)
 {
-    std::make_heap(first, last, comp);
-    std::sort_heap(first, last, comp);
+    std::size_t lo = r > n2 ? r - n2 : 0;
+    std::size_t hi = std::min(r, n1);
+    while (lo < hi)
+    {
+        std::size_t i = lo + (hi - lo) / 2;
+        std::size_t j = r - i;
+        if (j > 0 && i < n1 && !comp(first2[j-1], first1[i])) // A[i] <= B[j-1], A[i] must be in the prefix
+        {
+            lo = i + 1;
+        }
+        else
+        {
+            hi = i;
+        }
+    }
+    return lo;
 }
 
-// quick sort
-// time complexity: average O(NlogN), wrost O(N^2)
-// space complexity: O(1), inplace sorting
+// stable merge (moving elements) of [first1, last1) and [first2, last2) into dFirst with threadCount threads
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, std::random_access_iterator RandomIterator3, typename Compare>
+void parallelMerge(RandomIterator1 first1, RandomIterator1 last1, RandomIterator2 first2, RandomIterator2 last2, RandomIterator3 dFirst, Compare& comp, std::size_t threadCount)
+{
+    std::size_t n1 = last1 - first1;
+    std::size_t n2 = last2 - first2;
+    parallelFor(n1 + n2, threadCount, [&](std::size_t, std::size_t rBegin, std::size_t rEnd) {
+        std::size_t i1 = mergeCoRank(rBegin, first1, n1, first2, n2, comp);
+        std::size_t i2 = mergeCoRank(rEnd, first1, n1, first2, n2, comp);
+        std::merge(std::make_move_iterator(first1 + i1), std::make_move_iterator(first1 + i2),
+                   std::make_move_iterator(first2 + (rBegin - i1)), std::make_move_iterator(first2 + (rEnd - i2)),
+                   dFirst + rBegin, comp);
+    });
+}
+
+// same contract as mergeSortImpl, with threadCount threads
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Compare>
+void parallelMergeSortImpl(RandomIterator1 sFirst, RandomIterator1 sLast, RandomIterator2 dFirst, bool toDest, Compare comp, std::size_t threadCount)
+{
+    constexpr std::size_t sequentialThreshold = 1 << 14;
+    std::size_t N = sLast - sFirst;
+    if (threadCount <= 1 || N <= sequentialThreshold)
+    {
+        mergeSortImpl(sFirst, sLast, dFirst, toDest, comp);
+        return;
+    }
+    std::size_t offset = N / 2;
+    std::size_t leftThreads = threadCount / 2;
+    parallelInvoke([&]() { parallelMergeSortImpl(sFirst, sFirst + offset, dFirst, !toDest, comp, leftThreads); },
+                   [&]() { parallelMergeSortImpl(sFirst + offset, sLast, dFirst + offset, !toDest, comp, threadCount - leftThreads); });
+    if (toDest)
+    {
+        parallelMerge(sFirst, sFirst + offset, sFirst + offset, sLast, dFirst, comp, threadCount);
+    }
+    else
+    {
+        parallelMerge(dFirst, dFirst + offset, dFirst + offset, dFirst + N, sFirst, comp, threadCount);
+    }
+}
+} // namespace Impl
+
 template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
-void quickSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+void parallelMergeSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>(), std::size_t threadCount = Impl::defaultThreadCount())
 {
+    assert(first <= last);
     if (last - first <= 1)
         return;
-    auto pivot = *(first + (last-first) / 2);
-    auto middle1 = std::partition(first, last, [pivot, &comp](const auto& elem) { return comp(elem, pivot); });
-    auto middle2 = std::partition(middle1, last, [pivot, &comp](const auto& elem) { return !comp(pivot, elem); });
-    quickSort(first, middle1, comp);
-    quickSort(middle2, last, comp);
+    using value_type = std::iterator_traits<RandomIterator>::value_type;
+    std::vector<value_type> tmpVec;
+    tmpVec.reserve(last - first);
+    std::move(first, last, std::back_inserter(tmpVec));
+    Impl::parallelMergeSortImpl(tmpVec.begin(), tmpVec.end(), first, true, comp, threadCount);
 }
 
-// counting sort
-// time complexity: O(k+N), k is the upper bound of the range, N is input scale
-template<std::random_access_iterator RandomIterator> requires std::integral<typename std::iterator_traits<RandomIterator>::value_type>
-void countingSort(RandomIterator first, RandomIterator last, int K)
+// multiway merge : merge k sorted input ranges into an output iterator with a loser tree (tournament tree)
+// every internal node of the tree keeps the loser of the match between its two subtrees, the overall winner is kept at top.
+// after the winner is output, only the matches on the path from its leaf to the root are replayed.
+// the merge is stable: equal elements are output in the order of their input ranges.
+// time complexity: O(Nlogk), about log(k) comparisons per element
+// space complexity: O(k)
+namespace Impl
 {
-    std::vector<int> vec(K+1, 0);
-    for (auto iter = first; iter < last; ++iter)
+// loser tree over players [0, k), less(a, b) tells whether player a goes before player b,
+// an exhausted player must go after all other players.
+template<typename Less>
+class LoserTree
+{
+public:
+    LoserTree(std::size_t k, Less less)
+        : m_k(k)
+        , m_less(less)
+        , m_losers(std::max<std::size_t>(k, 1), 0)
     {
-        vec[*iter]++;
+        // leaf of player i is node k+i, children of node n are 2n and 2n+1, m_losers[0] is the winner
+        std::vector<std::size_t> winners(2 * k);
+        for (std::size_t i = 0; i < k; ++i)
+        {
+            winners[k + i] = i;
+        }
+        for (std::size_t n = k - 1; n >= 1 && n < k; --n)
+        {
+            std::size_t a = winners[2 * n];
+            std::size_t b = winners[2 * n + 1];
+            bool bWins = m_less(b, a);
+            winners[n] = bWins ? b : a;
+            m_losers[n] = bWins ? a : b;
+        }
+        m_losers[0] = k == 1 ? 0 : winners[1];
     }
-    for (int i = K; i >= 0;)
+    std::size_t winner() const
     {
-        if (vec[i] > 0)
+        return m_losers[0];
+    }
+    // the winner has changed, replay its matches up to the root
+    void replay()
+    {
+        std::size_t winner = m_losers[0];
+        for (std::size_t n = (m_k + winner) / 2; n >= 1; n /= 2)
         {
-            *(--last) = i;
-            vec[i]--;
+            if (m_less(m_losers[n], winner))
+            {
+                std::swap(m_losers[n], winner);
+            }
+        }
+        m_losers[0] = winner;
+    }
+private:
+    std::size_t m_k;
+    Less m_less;
+    std::vector<std::size_t> m_losers;
+};
+} // namespace Impl
+
+template<std::ranges::input_range Ranges, typename OutputIterator, typename Compare = std::less<>>
+    requires std::ranges::input_range<std::ranges::range_reference_t<Ranges>>
+OutputIterator multiwayMerge(Ranges&& ranges, OutputIterator out, Compare comp = std::less<>())
+{
+    using Range = std::ranges::range_reference_t<Ranges>;
+    std::vector<std::ranges::iterator_t<Range>> iters;
+    std::vector<std::ranges::sentinel_t<Range>> ends;
+    for (auto&& range : ranges)
+    {
+        iters.push_back(std::ranges::begin(range));
+        ends.push_back(std::ranges::end(range));
+    }
+    std::size_t k = iters.size();
+    if (k == 0)
+        return out;
+    auto less = [&](std::size_t a, std::size_t b) {
+        if (iters[a] == ends[a])
+            return false;
+        if (iters[b] == ends[b])
+            return true;
+        if (comp(*iters[a], *iters[b]))
+            return true;
+        return !comp(*iters[b], *iters[a]) && a < b;
+    };
+    Impl::LoserTree<decltype(less)> tree(k, less);
+    for (std::size_t w = tree.winner(); iters[w] != ends[w]; w = tree.winner())
+    {
+        *out++ = *iters[w];
+        ++iters[w];
+        tree.replay();
+    }
+    return out;
+}
+
+// parallel multiway merge : split the output into threadCount parts of equal size at exact ranks, merge every part by a thread
+// the split positions of rank r are found by multi-sequence selection over samples of every input at stride s,
+// from the largest power of 2 not above the longest input down to 1: the exact prefix of rank r/s at stride s
+// is found from the one at stride 2s by a heap over the inputs, at most k+1 elements are added or removed.
+// time complexity: O(N/P*logk + P*k*logk*logN)
+// space complexity: O(P*k)
+namespace Impl
+{
+// positions of ranges in splits, such that the first r elements of stable merge output are the elements before them
+template<typename RandomIterator, typename Compare>
+void multiwaySplit(const std::vector<RandomIterator>& firsts, const std::vector<RandomIterator>& lasts, std::size_t r, Compare& comp, std::size_t* splits)
+{
+    std::size_t k = firsts.size();
+    std::size_t maxLength = 0;
+    for (std::size_t j = 0; j < k; ++j)
+    {
+        splits[j] = 0;
+        maxLength = std::max<std::size_t>(maxLength, lasts[j] - firsts[j]);
+    }
+    if (maxLength == 0)
+        return;
+    // splits[j] is the number of samples taken from input j, sample q (1-based) of input j is firsts[j][q*s-1]
+    std::size_t s = std::bit_floor(maxLength);
+    auto sampleCount = [&](std::size_t j) -> std::size_t { return (lasts[j] - firsts[j]) / s; };
+    // order of stable merge: (value, input index, position)
+    auto before = [&](std::size_t i, std::size_t p, std::size_t j, std::size_t q) {
+        if (comp(firsts[i][p], firsts[j][q]))
+            return true;
+        return !comp(firsts[j][q], firsts[i][p]) && (i < j || (i == j && p < q));
+    };
+    std::vector<std::size_t> heap;
+    heap.reserve(k);
+    for (;;)
+    {
+        std::size_t total = 0, taken = 0;
+        for (std::size_t j = 0; j < k; ++j)
+        {
+            total += sampleCount(j);
+            taken += splits[j];
+        }
+        std::size_t target = std::min(r / s, total);
+        heap.clear();
+        if (taken < target)
+        {
+            // take the smallest next samples, min heap of inputs by their next sample
+            auto greater = [&](std::size_t i, std::size_t j) { return before(j, (splits[j] + 1) * s - 1, i, (splits[i] + 1) * s - 1); };
+            for (std::size_t j = 0; j < k; ++j)
+            {
+                if (splits[j] < sampleCount(j))
+                    heap.push_back(j);
+            }
+            std::make_heap(heap.begin(), heap.end(), greater);
+            for (; taken < target; ++taken)
+            {
+                std::pop_heap(heap.begin(), heap.end(), greater);
+                std::size_t j = heap.back();
+                if (++splits[j] < sampleCount(j))
+                    std::push_heap(heap.begin(), heap.end(), greater);
+                else
+                    heap.pop_back();
+            }
+        }
+        else if (taken > target)
+        {
+            // drop the largest taken samples, max heap of inputs by their last taken sample
+            auto less = [&](std::size_t i, std::size_t j) { return before(i, splits[i] * s - 1, j, splits[j] * s - 1); };
+            for (std::size_t j = 0; j < k; ++j)
+            {
+                if (splits[j] > 0)
+                    heap.push_back(j);
+            }
+            std::make_heap(heap.begin(), heap.end(), less);
+            for (; taken > target; --taken)
+            {
+                std::pop_heap(heap.begin(), heap.end(), less);
+                std::size_t j = heap.back();
+                if (--splits[j] > 0)
+                    std::push_heap(heap.begin(), heap.end(), less);
+                else
+                    heap.pop_back();
+            }
+        }
+        if (s == 1)
+            return;
+        // halve the stride: the taken samples and every sample before the largest of them still form a prefix of the order,
+        // the only new samples before it are the ones right after the taken samples of every input
+        s /= 2;
+        std::size_t largest = k;
+        for (std::size_t j = 0; j < k; ++j)
+        {
+            splits[j] *= 2;
+            if (splits[j] > 0 && (largest == k || before(largest, splits[largest] * s - 1, j, splits[j] * s - 1)))
+                largest = j;
+        }
+        if (largest == k)
+            continue;
+        std::size_t position = splits[largest] * s - 1;
+        for (std::size_t j = 0; j < k; ++j)
+        {
+            if (splits[j] < sampleCount(j) && before(j, (splits[j] + 1) * s - 1, largest, position))
+                splits[j]++;
+        }
+    }
+}
+} // namespace Impl
+
+template<std::ranges::input_range Ranges, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+    requires std::ranges::random_access_range<std::ranges::range_reference_t<Ranges>>
+RandomIterator parallelMultiwayMerge(Ranges&& ranges, RandomIterator out, Compare comp = std::less<>(), std::size_t threadCount = Impl::defaultThreadCount())
+{
+    using Range = std::ranges::range_reference_t<Ranges>;
+    using Iterator = std::ranges::iterator_t<Range>;
+    std::vector<Iterator> firsts;
+    std::vector<Iterator> lasts;
+    std::size_t N = 0;
+    for (auto&& range : ranges)
+    {
+        firsts.push_back(std::ranges::begin(range));
+        lasts.push_back(std::ranges::next(firsts.back(), std::ranges::end(range)));
+        N += lasts.back() - firsts.back();
+    }
+    std::size_t k = firsts.size();
+    Impl::parallelFor(N, threadCount, [&](std::size_t, std::size_t begin, std::size_t end) {
+        std::vector<std::size_t> splits(2 * k);
+        Impl::multiwaySplit(firsts, lasts, begin, comp, splits.data());
+        Impl::multiwaySplit(firsts, lasts, end, comp, splits.data() + k);
+        std::vector<std::ranges::subrange<Iterator>> parts;
+        for (std::size_t j = 0; j < k; ++j)
+        {
+            parts.emplace_back(firsts[j] + splits[j], firsts[j] + splits[k + j]);
+        }
+        multiwayMerge(parts, out + begin, comp);
+    });
+    return out + N;
+}
+
+// tim sort : adaptive stable natural merge sort (Tim Peters)
+// - split input into natural runs (non-descending, or strictly descending ones which are reversed in place),
+//   runs shorter than minRun are extended by binary insertion sort.
+// - runs are pushed onto a stack and merged when the stack invariants are violated, so merged runs have balanced lengths.
+// - a merge first skips the prefix of left run and the suffix of right run that are already in place,
+//   then copies the shorter run to a buffer and merges from the side of it.
+// - when one run keeps winning, the merge switches to galloping mode: exponential search for the end of the winning streak.
+// already sorted or reverse sorted input is sorted in O(N), time is proportional to the disorder of input.
+// time complexity: best O(N), wrost O(NlogN)
+// space complexity: O(N)
+namespace Impl
+{
+constexpr std::ptrdiff_t timSortMinMerge = 32;
+constexpr std::ptrdiff_t timSortMinGallop = 7;
+
+// binary insertion sort [first, last) stably, [first, start) is already sorted
+template<std::random_access_iterator RandomIterator, typename Compare>
+void binaryInsertionSort(RandomIterator first, RandomIterator last, RandomIterator start, Compare& comp)
+{
+    for (; start < last; ++start)
+    {
+        auto pivot = std::move(*start);
+        auto pos = std::upper_bound(first, start, pivot, comp);
+        std::move_backward(pos, start, start + 1);
+        *pos = std::move(pivot);
+    }
+}
+
+// length of the run starting at first, a strictly descending run is reversed
+template<std::random_access_iterator RandomIterator, typename Compare>
+std::ptrdiff_t timSortCountRun(RandomIterator first, RandomIterator last, Compare& comp)
+{
+    auto runLast = first + 1;
+    if (runLast == last)
+        return 1;
+    if (comp(*runLast++, *first))
+    {
+        while (runLast < last && comp(*runLast, *(runLast-1)))
+            ++runLast;
+        std::reverse(first, runLast);
+    }
+    else
+    {
+        while (runLast < last && !comp(*runLast, *(runLast-1)))
+            ++runLast;
+    }
+    return runLast - first;
+}
+
+// the leftmost position to insert key into sorted base[0, len), search from base[hint] exponentially
+template<typename Value, std::random_access_iterator RandomIterator, typename Compare>
+std::ptrdiff_t gallopLeft(const Value& key, RandomIterator base, std::ptrdiff_t len, std::ptrdiff_t hint, Compare& comp)
+{
+    std::ptrdiff_t lastOfs = 0, ofs = 1;
+    if (comp(base[hint], key)) // gallop right until base[hint+lastOfs] < key <= base[hint+ofs]
+    {
+        std::ptrdiff_t maxOfs = len - hint;
+        while (ofs < maxOfs && comp(base[hint + ofs], key))
+        {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, maxOfs);
+        lastOfs += hint;
+        ofs += hint;
+    }
+    else // gallop left until base[hint-ofs] < key <= base[hint-lastOfs]
+    {
+        std::ptrdiff_t maxOfs = hint + 1;
+        while (ofs < maxOfs && !comp(base[hint - ofs], key))
+        {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, maxOfs);
+        std::ptrdiff_t tmp = lastOfs;
+        lastOfs = hint - ofs;
+        ofs = hint - tmp;
+    }
+    // base[lastOfs] < key <= base[ofs], binary search in (lastOfs, ofs]
+    ++lastOfs;
+    while (lastOfs < ofs)
+    {
+        std::ptrdiff_t mid = lastOfs + (ofs - lastOfs) / 2;
+        if (comp(base[mid], key))
+            lastOfs = mid + 1;
+        else
+            ofs = mid;
+    }
+    return ofs;
+}
+
+// the rightmost position to insert key into sorted base[0, len), search from base[hint] exponentially
+template<typename Value, std::random_access_iterator RandomIterator, typename Compare>
+std::ptrdiff_t gallopRight(const Value& key, RandomIterator base, std::ptrdiff_t len, std::ptrdiff_t hint, Compare& comp)
+{
+    std::ptrdiff_t lastOfs = 0, ofs = 1;
+    if (comp(key, base[hint])) // gallop left until base[hint-ofs] <= key < base[hint-lastOfs]
+    {
+        std::ptrdiff_t maxOfs = hint + 1;
+        while (ofs < maxOfs && comp(key, base[hint - ofs]))
+        {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        ofs = std::min(ofs, maxOfs);
+        std::ptrdiff_t tmp = lastOfs;
+        lastOfs = hint - ofs;
+        ofs = hint - tmp;
+    }
+    else // gallop right until base[hint+lastOfs] <= key < base[hint+ofs]
+    {
+        std::ptrdiff_t maxOfs = len - hint;
+        while (ofs < maxOfs && !comp(key, base[hint + ofs]))
+        {
+            lastOfs = ofs;
+            ofs = 2 * ofs + 1;
         }
+        ofs = std::min(ofs, maxOfs);
+        lastOfs += hint;
+        ofs += hint;
+    }
+    // base[lastOfs] <= key < base[ofs], binary search in (lastOfs, ofs]
+    ++lastOfs;
+    while (lastOfs < ofs)
+    {
+        std::ptrdiff_t mid = lastOfs + (ofs - lastOfs) / 2;
+        if (comp(key, base[mid]))
+            ofs = mid;
         else
+            lastOfs = mid + 1;
+    }
+    return ofs;
+}
+
+// runs and merge state of tim sort, positions are indexes relative to first
+template<std::random_access_iterator RandomIterator, typename Compare>
+class TimSorter
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    struct Run
+    {
+        std::ptrdiff_t base;
+        std::ptrdiff_t len;
+    };
+public:
+    TimSorter(RandomIterator first, Compare& comp) : a(first), m_comp(comp)
+    {
+    }
+    void pushRun(std::ptrdiff_t base, std::ptrdiff_t len)
+    {
+        m_runs.push_back({base, len});
+    }
+    // merge runs until the invariants hold for the top of stack:
+    // len[n-2] > len[n-1] + len[n] and len[n-1] > len[n]
+    void mergeCollapse()
+    {
+        while (m_runs.size() > 1)
         {
-            --i;
+            std::ptrdiff_t n = static_cast<std::ptrdiff_t>(m_runs.size()) - 2;
+            if ((n > 0 && m_runs[n-1].len <= m_runs[n].len + m_runs[n+1].len) || (n > 1 && m_runs[n-2].len <= m_runs[n-1].len + m_runs[n].len))
+            {
+                if (m_runs[n-1].len < m_runs[n+1].len)
+                    --n;
+            }
+            else if (m_runs[n].len > m_runs[n+1].len)
+            {
+                break;
+            }
+            mergeAt(n);
+        }
+    }
+    void mergeForceCollapse()
+    {
+        while (m_runs.size() > 1)
+        {
+            std::ptrdiff_t n = static_cast<std::ptrdiff_t>(m_runs.size()) - 2;
+            if (n > 0 && m_runs[n-1].len < m_runs[n+1].len)
+                --n;
+            mergeAt(n);
+        }
+    }
+private:
+    // merge run i and run i+1
+    void mergeAt(std::ptrdiff_t i)
+    {
+        std::ptrdiff_t base1 = m_runs[i].base, len1 = m_runs[i].len;
+        std::ptrdiff_t base2 = m_runs[i+1].base, len2 = m_runs[i+1].len;
+        m_runs[i].len = len1 + len2;
+        m_runs.erase(m_runs.begin() + (i + 1));
+        // elements of run1 before the position of run2[0] are already in place
+        std::ptrdiff_t k = gallopRight(a[base2], a + base1, len1, 0, m_comp);
+        base1 += k;
+        len1 -= k;
+        if (len1 == 0)
+            return;
+        // elements of run2 after the position of run1[len1-1] are already in place
+        len2 = gallopLeft(a[base1 + len1 - 1], a + base2, len2, len2 - 1, m_comp);
+        if (len2 == 0)
+            return;
+        if (len1 <= len2)
+            mergeLo(base1, len1, base2, len2);
+        else
+            mergeHi(base1, len1, base2, len2);
+    }
+    // merge from left to right, the shorter run1 is moved to buffer
+    // run2[0] goes before run1[0] and run1[len1-1] goes after run2[len2-1], they are guaranteed by mergeAt
+    void mergeLo(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2)
+    {
+        m_buffer.clear();
+        std::move(a + base1, a + (base1 + len1), std::back_inserter(m_buffer));
+        auto t = m_buffer.begin();
+        std::ptrdiff_t cursor1 = 0, cursor2 = base2, dest = base1;
+        a[dest++] = std::move(a[cursor2++]);
+        if (--len2 == 0)
+        {
+            std::move(t + cursor1, t + (cursor1 + len1), a + dest);
+            return;
+        }
+        if (len1 == 1)
+        {
+            std::move(a + cursor2, a + (cursor2 + len2), a + dest);
+            a[dest + len2] = std::move(t[cursor1]);
+            return;
+        }
+        std::ptrdiff_t minGallop = m_minGallop;
+        while (true)
+        {
+            std::ptrdiff_t count1 = 0, count2 = 0; // number of times in a row that run1 or run2 wins
+            // one element a time until one run starts winning consistently
+            do
+            {
+                if (m_comp(a[cursor2], t[cursor1]))
+                {
+                    a[dest++] = std::move(a[cursor2++]);
+                    ++count2;
+                    count1 = 0;
+                    if (--len2 == 0)
+                        goto finish;
+                }
+                else
+                {
+                    a[dest++] = std::move(t[cursor1++]);
+                    ++count1;
+                    count2 = 0;
+                    if (--len1 == 1)
+                        goto finish;
+                }
+            } while ((count1 | count2) < minGallop);
+            // galloping until neither run wins consistently
+            do
+            {
+                count1 = gallopRight(a[cursor2], t + cursor1, len1, 0, m_comp);
+                if (count1 != 0)
+                {
+                    std::move(t + cursor1, t + (cursor1 + count1), a + dest);
+                    dest += count1;
+                    cursor1 += count1;
+                    len1 -= count1;
+                    if (len1 <= 1)
+                        goto finish;
+                }
+                a[dest++] = std::move(a[cursor2++]);
+                if (--len2 == 0)
+                    goto finish;
+                count2 = gallopLeft(t[cursor1], a + cursor2, len2, 0, m_comp);
+                if (count2 != 0)
+                {
+                    std::move(a + cursor2, a + (cursor2 + count2), a + dest);
+                    dest += count2;
+                    cursor2 += count2;
+                    len2 -= count2;
+                    if (len2 == 0)
+                        goto finish;
+                }
+                a[dest++] = std::move(t[cursor1++]);
+                if (--len1 == 1)
+                    goto finish;
+                --minGallop;
+            } while (count1 >= timSortMinGallop || count2 >= timSortMinGallop);
+            minGallop = std::max<std::ptrdiff_t>(minGallop, 0) + 2; // penalize leaving galloping mode
+        }
+    finish:
+        m_minGallop = std::max<std::ptrdiff_t>(minGallop, 1);
+        if (len1 == 1)
+        {
+            std::move(a + cursor2, a + (cursor2 + len2), a + dest);
+            a[dest + len2] = std::move(t[cursor1]); // the last element of run1 is greater than all of run2
+        }
+        else
+        {
+            assert(len1 != 0); // comparison function is not a strict weak ordering
+            std::move(t + cursor1, t + (cursor1 + len1), a + dest);
+        }
+    }
+    // merge from right to left, the shorter run2 is moved to buffer
+    void mergeHi(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2)
+    {
+        m_buffer.clear();
+        std::move(a + base2, a + (base2 + len2), std::back_inserter(m_buffer));
+        auto t = m_buffer.begin();
+        std::ptrdiff_t cursor1 = base1 + len1 - 1, cursor2 = len2 - 1, dest = base2 + len2 - 1;
+        a[dest--] = std::move(a[cursor1--]);
+        if (--len1 == 0)
+        {
+            std::move(t, t + len2, a + (dest - (len2 - 1)));
+            return;
+        }
+        if (len2 == 1)
+        {
+            dest -= len1;
+            cursor1 -= len1;
+            std::move_backward(a + (cursor1 + 1), a + (cursor1 + 1 + len1), a + (dest + 1 + len1));
+            a[dest] = std::move(t[cursor2]);
+            return;
+        }
+        std::ptrdiff_t minGallop = m_minGallop;
+        while (true)
+        {
+            std::ptrdiff_t count1 = 0, count2 = 0;
+            do
+            {
+                if (m_comp(t[cursor2], a[cursor1]))
+                {
+                    a[dest--] = std::move(a[cursor1--]);
+                    ++count1;
+                    count2 = 0;
+                    if (--len1 == 0)
+                        goto finish;
+                }
+                else
+                {
+                    a[dest--] = std::move(t[cursor2--]);
+                    ++count2;
+                    count1 = 0;
+                    if (--len2 == 1)
+                        goto finish;
+                }
+            } while ((count1 | count2) < minGallop);
+            do
+            {
+                count1 = len1 - gallopRight(t[cursor2], a + base1, len1, len1 - 1, m_comp);
+                if (count1 != 0)
+                {
+                    dest -= count1;
+                    cursor1 -= count1;
+                    len1 -= count1;
+                    std::move_backward(a + (cursor1 + 1), a + (cursor1 + 1 + count1), a + (dest + 1 + count1));
+                    if (len1 == 0)
+                        goto finish;
+                }
+                a[dest--] = std::move(t[cursor2--]);
+                if (--len2 == 1)
+                    goto finish;
+                count2 = len2 - gallopLeft(a[cursor1], t, len2, len2 - 1, m_comp);
+                if (count2 != 0)
+                {
+                    dest -= count2;
+                    cursor2 -= count2;
+                    len2 -= count2;
+                    std::move(t + (cursor2 + 1), t + (cursor2 + 1 + count2), a + (dest + 1));
+                    if (len2 <= 1)
+                        goto finish;
+                }
+                a[dest--] = std::move(a[cursor1--]);
+                if (--len1 == 0)
+                    goto finish;
+                --minGallop;
+            } while (count1 >= timSortMinGallop || count2 >= timSortMinGallop);
+            minGallop = std::max<std::ptrdiff_t>(minGallop, 0) + 2;
+        }
+    finish:
+        m_minGallop = std::max<std::ptrdiff_t>(minGallop, 1);
+        if (len2 == 1)
+        {
+            dest -= len1;
+            cursor1 -= len1;
+            std::move_backward(a + (cursor1 + 1), a + (cursor1 + 1 + len1), a + (dest + 1 + len1));
+            a[dest] = std::move(t[cursor2]); // the first element of run2 is less than all of run1
+        }
+        else
+        {
+            assert(len2 != 0); // comparison function is not a strict weak ordering
+            std::move(t, t + len2, a + (dest - (len2 - 1)));
+        }
+    }
+private:
+    RandomIterator a;
+    Compare& m_comp;
+    std::ptrdiff_t m_minGallop = timSortMinGallop;
+    std::vector<Run> m_runs;
+    std::vector<value_type> m_buffer;
+};
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void timSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    std::ptrdiff_t N = last - first;
+    if (N < 2)
+        return;
+    if (N < Impl::timSortMinMerge) // one mini run
+    {
+        std::ptrdiff_t runLen = Impl::timSortCountRun(first, last, comp);
+        Impl::binaryInsertionSort(first, last, first + runLen, comp);
+        return;
+    }
+    // minRun in [timSortMinMerge/2, timSortMinMerge], N/minRun is a power of 2 or a little less than it
+    std::ptrdiff_t minRun = N, r = 0;
+    while (minRun >= Impl::timSortMinMerge)
+    {
+        r |= minRun & 1;
+        minRun >>= 1;
+    }
+    minRun += r;
+    Impl::TimSorter<RandomIterator, Compare> sorter(first, comp);
+    for (std::ptrdiff_t lo = 0; lo < N;)
+    {
+        std::ptrdiff_t runLen = Impl::timSortCountRun(first + lo, last, comp);
+        if (runLen < minRun)
+        {
+            std::ptrdiff_t force = std::min(N - lo, minRun);
+            Impl::binaryInsertionSort(first + lo, first + (lo + force), first + (lo + runLen), comp);
+            runLen = force;
+        }
+        sorter.pushRun(lo, runLen);
+        sorter.mergeCollapse();
+        lo += runLen;
+    }
+    sorter.mergeForceCollapse();
+}
+
+// d-ary heap : a complete D-ary tree stored in [first, last), children of node i are D*i+1 ... D*i+D
+// comp(a, b) means a has lower priority than b, so *first is the greatest element, same as std::make_heap.
+// a wider node makes the tree log2(D) times shallower and the children of a node share one or two cache lines,
+// so sift-down misses cache much less often than a binary heap when the heap does not fit in cache.
+// sift-down is bottom-up (Floyd): the hole goes down to a leaf along the greatest children without comparing them
+// to the sifted value, then the value goes up from the leaf. the sifted value is usually taken from the bottom and
+// belongs near the bottom again, so it saves about one comparison per level.
+// time complexity: makeHeap O(N), pushHeap O(log_D(N)), popHeap O(Dlog_D(N))
+// space complexity: O(1)
+namespace Impl
+{
+// grandchildren of a node are contiguous, prefetch them while the children are being compared
+template<std::random_access_iterator RandomIterator>
+void heapPrefetch(RandomIterator first, std::size_t index, std::size_t N)
+{
+#if defined(__GNUC__)
+    if constexpr (std::contiguous_iterator<RandomIterator>)
+    {
+        if (index < N)
+            __builtin_prefetch(std::to_address(first + index));
+    }
+#endif
+}
+
+// move value up from hole until its parent is not less than it, the hole does not go above top
+template<std::size_t D, std::random_access_iterator RandomIterator, typename T, typename Compare>
+void heapSiftUp(RandomIterator first, std::size_t hole, std::size_t top, T&& value, Compare& comp)
+{
+    while (hole > top)
+    {
+        std::size_t parent = (hole - 1) / D;
+        if (!comp(first[parent], value))
+            break;
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+    }
+    first[hole] = std::move(value);
+}
+
+// fill the hole at index hole of heap [first, first + N) with value, the subtrees of hole must be heaps
+template<std::size_t D, std::random_access_iterator RandomIterator, typename T, typename Compare>
+void heapSiftDown(RandomIterator first, std::size_t hole, std::size_t N, T&& value, Compare& comp)
+{
+    std::size_t top = hole;
+    while (true)
+    {
+        std::size_t child = D * hole + 1;
+        if (child >= N)
+            break;
+        std::size_t greatest = child;
+        heapPrefetch(first, D * child + 1, N);
+        if (child + D <= N) // full node, pairwise tournament: log(D) rounds of independent comparisons, winners are selected without branch
+        {
+            std::array<std::size_t, D> winners;
+            for (std::size_t i = 0; i < D; ++i)
+            {
+                winners[i] = child + i;
+            }
+            for (std::size_t width = D; width > 1; width = (width + 1) / 2)
+            {
+                for (std::size_t i = 0; i < width / 2; ++i)
+                {
+                    std::size_t left = winners[2 * i];
+                    std::size_t right = winners[2 * i + 1];
+                    winners[i] = comp(first[left], first[right]) ? right : left;
+                }
+                if (width % 2 == 1)
+                    winners[width / 2] = winners[width - 1];
+            }
+            greatest = winners[0];
+        }
+        else
+        {
+            for (std::size_t i = child + 1; i < N; ++i)
+            {
+                if (comp(first[greatest], first[i]))
+                    greatest = i;
+            }
+        }
+        first[hole] = std::move(first[greatest]);
+        hole = greatest;
+    }
+    heapSiftUp<D>(first, hole, top, std::move(value), comp);
+}
+} // namespace Impl
+
+template<std::size_t D = 4, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void makeHeap(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    static_assert(D >= 2);
+    std::size_t N = last - first;
+    if (N <= 1)
+        return;
+    for (std::size_t i = (N - 2) / D + 1; i-- > 0;)
+    {
+        auto value = std::move(first[i]);
+        Impl::heapSiftDown<D>(first, i, N, std::move(value), comp);
+    }
+}
+
+// [first, last - 1) is a heap, push *(last - 1) into it
+template<std::size_t D = 4, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void pushHeap(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    static_assert(D >= 2);
+    std::size_t N = last - first;
+    if (N <= 1)
+        return;
+    auto value = std::move(first[N-1]);
+    Impl::heapSiftUp<D>(first, N - 1, 0, std::move(value), comp);
+}
+
+// [first, last) is a heap, move the greatest element to *(last - 1) and make [first, last - 1) a heap
+template<std::size_t D = 4, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void popHeap(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    static_assert(D >= 2);
+    std::size_t N = last - first;
+    if (N <= 1)
+        return;
+    auto value = std::move(first[N-1]);
+    first[N-1] = std::move(first[0]);
+    Impl::heapSiftDown<D>(first, 0, N - 1, std::move(value), comp);
+}
+
+// sort heap [first, last) in ascending order
+template<std::size_t D = 4, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void sortHeap(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    for (; last - first > 1; --last)
+    {
+        popHeap<D>(first, last, comp);
+    }
+}
+
+template<std::size_t D = 4, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+bool isHeap(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    std::size_t N = last - first;
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        if (comp(first[(i - 1) / D], first[i]))
+            return false;
+    }
+    return true;
+}
+
+// heap sort : build a D-ary heap, then pop the greatest element to the end repeatedly
+// 4-ary heap by default, which takes fewer comparisons and cache misses than a binary heap.
+// time complexity: O(NlogN)
+// space complexity: O(1), inplace sorting
+template<std::size_t D = 4, std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void heapSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    makeHeap<D>(first, last, comp);
+    sortHeap<D>(first, last, comp);
+}
+
+// priority queue : max priority queue on a D-ary heap in a vector, top() is the greatest element by comp
+// time complexity: push O(log_D(N)), pop O(Dlog_D(N)), top O(1)
+// space complexity: O(N)
+template<typename T, std::size_t D = 4, typename Compare = std::less<>>
+class PriorityQueue
+{
+    static_assert(D >= 2);
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = const T&;
+    PriorityQueue(const Compare& comp = Compare()) : m_comp(comp)
+    {
+    }
+    template<std::input_iterator InputIterator>
+    PriorityQueue(InputIterator first, InputIterator last, const Compare& comp = Compare()) : m_data(first, last), m_comp(comp)
+    {
+        makeHeap<D>(m_data.begin(), m_data.end(), m_comp);
+    }
+    bool empty() const
+    {
+        return m_data.empty();
+    }
+    size_type size() const
+    {
+        return m_data.size();
+    }
+    const_reference top() const
+    {
+        assert(!empty());
+        return m_data.front();
+    }
+    void push(const T& value)
+    {
+        m_data.push_back(value);
+        pushHeap<D>(m_data.begin(), m_data.end(), m_comp);
+    }
+    void push(T&& value)
+    {
+        m_data.push_back(std::move(value));
+        pushHeap<D>(m_data.begin(), m_data.end(), m_comp);
+    }
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        m_data.emplace_back(std::forward<Args>(args)...);
+        pushHeap<D>(m_data.begin(), m_data.end(), m_comp);
+    }
+    void pop()
+    {
+        assert(!empty());
+        popHeap<D>(m_data.begin(), m_data.end(), m_comp);
+        m_data.pop_back();
+    }
+    // pop the top element and return it
+    T extractTop()
+    {
+        assert(!empty());
+        popHeap<D>(m_data.begin(), m_data.end(), m_comp);
+        T res = std::move(m_data.back());
+        m_data.pop_back();
+        return res;
+    }
+    // replace the top element by value, cheaper than pop() then push()
+    void replaceTop(T value)
+    {
+        assert(!empty());
+        Impl::heapSiftDown<D>(m_data.begin(), 0, m_data.size(), std::move(value), m_comp);
+    }
+    void reserve(size_type capacity)
+    {
+        m_data.reserve(capacity);
+    }
+    void clear()
+    {
+        m_data.clear();
+    }
+    // the underlying heap array, in heap order
+    const std::vector<T>& data() const
+    {
+        return m_data;
+    }
+private:
+    std::vector<T> m_data;
+    Compare m_comp;
+};
+
+// partition : reorder [first, last) so that elements satisfying pred precede the others, not stable
+// block partition (BlockQuicksort by Edelkamp and Weiss): scan a block from each end and record offsets of misplaced elements
+// without branching on the predicate result, then swap the recorded elements in bulk.
+// return the first element of the second group.
+// time complexity: O(N)
+// space complexity: O(1), inplace
+template<std::random_access_iterator RandomIterator, typename Predicate>
+RandomIterator partition(RandomIterator first, RandomIterator last, Predicate pred)
+{
+    constexpr std::ptrdiff_t blockSize = 64;
+    unsigned char offsetsL[blockSize];
+    unsigned char offsetsR[blockSize];
+    std::ptrdiff_t numL = 0, numR = 0, startL = 0, startR = 0;
+    // [first, lo) satisfy pred, [hi, last) do not, the left block is [lo, lo + blockSize), the right block is [hi - blockSize, hi)
+    auto lo = first, hi = last;
+    while (hi - lo > 2 * blockSize)
+    {
+        if (numL == 0)
+        {
+            startL = 0;
+            for (std::ptrdiff_t i = 0; i < blockSize; ++i)
+            {
+                offsetsL[numL] = static_cast<unsigned char>(i);
+                numL += !pred(lo[i]);
+            }
+        }
+        if (numR == 0)
+        {
+            startR = 0;
+            for (std::ptrdiff_t i = 0; i < blockSize; ++i)
+            {
+                offsetsR[numR] = static_cast<unsigned char>(i);
+                numR += static_cast<bool>(pred(*(hi - 1 - i)));
+            }
+        }
+        std::ptrdiff_t num = std::min(numL, numR);
+        for (std::ptrdiff_t i = 0; i < num; ++i)
+        {
+            std::iter_swap(lo + offsetsL[startL + i], hi - 1 - offsetsR[startR + i]);
+        }
+        numL -= num;
+        numR -= num;
+        startL += num;
+        startR += num;
+        if (numL == 0)
+            lo += blockSize;
+        if (numR == 0)
+            hi -= blockSize;
+    }
+    // at most 2 blocks left unprocessed, partition them one by one
+    while (true)
+    {
+        while (lo < hi && pred(*lo))
+            ++lo;
+        while (lo < hi && !pred(*(hi-1)))
+            --hi;
+        if (lo >= hi)
+            return lo;
+        std::iter_swap(lo++, --hi);
+    }
+}
+
+// quick sort : introspective, pattern-defeating quick sort (pdqsort by Orson Peters)
+// - pivot is the median of 3 elements, or the pseudo median of 9 elements (ninther) for large ranges.
+// - small ranges are sorted by insertion sort.
+// - when too many unbalanced partitions happen, fall back to heap sort to guarantee O(NlogN).
+// - if a partition did not swap anything, the range may be already sorted, try to finish it by a bounded insertion sort.
+// - if the pivot equals the pivot of parent partition, put all elements equal to pivot to the left and skip them.
+// time complexity: best O(N), wrost O(NlogN), average O(NlogN)
+// space complexity: O(logN), inplace sorting
+namespace Impl
+{
+constexpr std::ptrdiff_t quickSortInsertionThreshold = 24;
+constexpr std::ptrdiff_t quickSortNintherThreshold = 128;
+
+// sort *a, *b, *c
+template<std::random_access_iterator RandomIterator, typename Compare>
+void sort3(RandomIterator a, RandomIterator b, RandomIterator c, Compare& comp)
+{
+    if (comp(*b, *a))
+        std::iter_swap(a, b);
+    if (comp(*c, *b))
+        std::iter_swap(b, c);
+    if (comp(*b, *a))
+        std::iter_swap(a, b);
+}
+
+// insertion sort that gives up when it has to move too many elements, return true if [first, last) is sorted
+template<std::random_access_iterator RandomIterator, typename Compare>
+bool partialInsertionSort(RandomIterator first, RandomIterator last, Compare& comp)
+{
+    constexpr std::ptrdiff_t moveLimit = 8;
+    if (first == last)
+        return true;
+    std::ptrdiff_t moves = 0;
+    for (auto iter = first + 1; iter != last; ++iter)
+    {
+        if (!comp(*iter, *(iter-1)))
+            continue;
+        auto key = std::move(*iter);
+        auto iter2 = iter;
+        do
+        {
+            *iter2 = std::move(*(iter2-1));
+            --iter2;
+        } while (iter2 != first && comp(key, *(iter2-1)));
+        *iter2 = std::move(key);
+        moves += iter - iter2;
+        if (moves > moveLimit)
+            return iter + 1 == last;
+    }
+    return true;
+}
+
+// partition [first, last) around pivot *first, elements less than pivot go to the left, others go to the right.
+// there must be an element not less than pivot in [first+1, last), the median-of-3 pivot selection guarantees that.
+// return the final pivot position and whether the range was already partitioned.
+template<std::random_access_iterator RandomIterator, typename Compare>
+std::pair<RandomIterator, bool> partitionRight(RandomIterator first, RandomIterator last, Compare& comp)
+{
+    auto pivot = std::move(*first);
+    auto lo = first, hi = last;
+    while (comp(*++lo, pivot));
+    if (lo - 1 == first)
+        while (lo < hi && !comp(*--hi, pivot));
+    else
+        while (!comp(*--hi, pivot)); // guarded by *(lo-1) < pivot
+    bool alreadyPartitioned = lo >= hi;
+    if constexpr (std::is_arithmetic_v<typename std::iterator_traits<RandomIterator>::value_type>)
+    {
+        // cheap comparisons: branch mispredictions dominate, use the branchless block partition
+        if (!alreadyPartitioned)
+        {
+            std::iter_swap(lo, hi);
+            lo = CLRS::partition(lo + 1, hi, [&pivot, &comp](const auto& elem) { return comp(elem, pivot); });
+        }
+    }
+    else
+    {
+        while (lo < hi)
+        {
+            std::iter_swap(lo, hi);
+            while (comp(*++lo, pivot));
+            while (!comp(*--hi, pivot));
+        }
+    }
+    auto pivotPos = lo - 1;
+    *first = std::move(*pivotPos);
+    *pivotPos = std::move(pivot);
+    return std::make_pair(pivotPos, alreadyPartitioned);
+}
+
+// partition [first, last) around pivot *first, elements equal to pivot go to the left, greater ones go to the right.
+// used when pivot is known to be not greater than any element, return the final pivot position.
+template<std::random_access_iterator RandomIterator, typename Compare>
+RandomIterator partitionLeft(RandomIterator first, RandomIterator last, Compare& comp)
+{
+    auto pivot = std::move(*first);
+    auto lo = first, hi = last;
+    while (comp(pivot, *--hi));
+    if (hi + 1 == last)
+        while (lo < hi && !comp(pivot, *++lo));
+    else
+        while (!comp(pivot, *++lo)); // guarded by pivot < *(hi+1)
+    while (lo < hi)
+    {
+        std::iter_swap(lo, hi);
+        while (comp(pivot, *--hi));
+        while (!comp(pivot, *++lo));
+    }
+    *first = std::move(*hi);
+    *hi = std::move(pivot);
+    return hi;
+}
+
+// badAllowed: number of unbalanced partitions allowed before falling back to heap sort
+// leftmost: whether [first, last) is the leftmost part, if not, *(first-1) is not greater than any element in it
+template<std::random_access_iterator RandomIterator, typename Compare>
+void quickSortImpl(RandomIterator first, RandomIterator last, Compare& comp, int badAllowed, bool leftmost)
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    while (true)
+    {
+        std::ptrdiff_t size = last - first;
+        if constexpr (sortingNetworkAscending<value_type, Compare> || sortingNetworkDescending<value_type, Compare>)
+        {
+            if (size <= static_cast<std::ptrdiff_t>(smallSortMaxSize))
+            {
+                smallSortOrInsertionSort(first, last, comp);
+                return;
+            }
+        }
+        else if (size < quickSortInsertionThreshold)
+        {
+            if (size > 1)
+                insertionSort(first, last, comp);
+            return;
+        }
+        // choose pivot and move it to *first
+        std::ptrdiff_t half = size / 2;
+        if (size > quickSortNintherThreshold)
+        {
+            sort3(first, first + half, last - 1, comp);
+            sort3(first + 1, first + (half - 1), last - 2, comp);
+            sort3(first + 2, first + (half + 1), last - 3, comp);
+            sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            std::iter_swap(first, first + half);
+        }
+        else
+        {
+            sort3(first + half, first, last - 1, comp);
+        }
+        // pivot equals to the pivot of parent partition: many equal elements, skip them all
+        if (!leftmost && !comp(*(first-1), *first))
+        {
+            first = partitionLeft(first, last, comp) + 1;
+            continue;
+        }
+        auto [pivotPos, alreadyPartitioned] = partitionRight(first, last, comp);
+        std::ptrdiff_t leftSize = pivotPos - first;
+        std::ptrdiff_t rightSize = last - (pivotPos + 1);
+        if (leftSize < size / 8 || rightSize < size / 8) // highly unbalanced
+        {
+            if (--badAllowed == 0)
+            {
+                heapSort(first, last, comp);
+                return;
+            }
+            // break the pattern of input by swapping some elements
+            if (leftSize >= quickSortInsertionThreshold)
+            {
+                std::iter_swap(first, first + leftSize / 4);
+                std::iter_swap(pivotPos - 1, pivotPos - leftSize / 4);
+            }
+            if (rightSize >= quickSortInsertionThreshold)
+            {
+                std::iter_swap(pivotPos + 1, pivotPos + (1 + rightSize / 4));
+                std::iter_swap(last - 1, last - rightSize / 4);
+            }
+        }
+        else if (alreadyPartitioned && partialInsertionSort(first, pivotPos, comp) && partialInsertionSort(pivotPos + 1, last, comp))
+        {
+            return;
+        }
+        // recurse into the smaller part and loop on the larger part, the stack depth is bounded by O(logN)
+        if (leftSize < rightSize)
+        {
+            quickSortImpl(first, pivotPos, comp, badAllowed, leftmost);
+            first = pivotPos + 1;
+            leftmost = false;
+        }
+        else
+        {
+            quickSortImpl(pivotPos + 1, last, comp, badAllowed, false);
+            last = pivotPos;
+        }
+    }
+}
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void quickSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>())
+{
+    if (last - first <= 1)
+        return;
+    int badAllowed = std::bit_width(static_cast<std::size_t>(last - first));
+    Impl::quickSortImpl(first, last, comp, badAllowed, true);
+}
+
+// selection : reorder [first, last) so that *nth is the element that would be there if the range were sorted,
+// no element in [first, nth) is greater than *nth and no element in [nth + 1, last) is less than it (introselect by Musser).
+// - quick select on the partitions of quick sort, pivot is the median of 3 elements or the ninther, only the part
+//   containing nth is kept.
+// - when too many unbalanced partitions happen, pivots are chosen by median of medians (Blum, Floyd, Pratt, Rivest and Tarjan):
+//   median of every group of 5 elements, then the median of these medians selected recursively,
+//   at least 3/10 of the elements are on each side of it, so the rest of the selection is linear in worst case.
+// time complexity: average O(N), worst O(N)
+// space complexity: O(logN), inplace
+namespace Impl
+{
+constexpr std::ptrdiff_t selectInsertionThreshold = 24;
+
+// move the median of medians of groups of 5 elements of [first, last) to *first
+template<std::random_access_iterator RandomIterator, typename Compare>
+void medianOfMediansPivot(RandomIterator first, RandomIterator last, Compare& comp);
+
+// badAllowed: number of unbalanced partitions allowed before switching to median of medians, <= 0 to use it from the start
+// leftmost: whether *(first-1) is out of the range, if not, it is not greater than any element in [first, last)
+template<std::random_access_iterator RandomIterator, typename Compare>
+void selectImpl(RandomIterator first, RandomIterator nth, RandomIterator last, Compare& comp, int badAllowed, bool leftmost)
+{
+    while (true)
+    {
+        std::ptrdiff_t size = last - first;
+        if (size < selectInsertionThreshold)
+        {
+            if (size > 1)
+                insertionSort(first, last, comp);
+            return;
+        }
+        if (badAllowed <= 0)
+        {
+            medianOfMediansPivot(first, last, comp);
+        }
+        else
+        {
+            std::ptrdiff_t half = size / 2;
+            if (size > quickSortNintherThreshold)
+            {
+                sort3(first, first + half, last - 1, comp);
+                sort3(first + 1, first + (half - 1), last - 2, comp);
+                sort3(first + 2, first + (half + 1), last - 3, comp);
+                sort3(first + (half - 1), first + half, first + (half + 1), comp);
+                std::iter_swap(first, first + half);
+            }
+            else
+            {
+                sort3(first + half, first, last - 1, comp);
+            }
+        }
+        // pivot equals to the previous pivot: drop all elements equal to it at once
+        if (!leftmost && !comp(*(first-1), *first))
+        {
+            auto pivotPos = partitionLeft(first, last, comp);
+            if (nth <= pivotPos)
+                return;
+            first = pivotPos + 1;
+            continue;
+        }
+        auto pivotPos = partitionRight(first, last, comp).first;
+        std::ptrdiff_t leftSize = pivotPos - first;
+        std::ptrdiff_t rightSize = last - (pivotPos + 1);
+        if (leftSize < size / 8 || rightSize < size / 8)
+            --badAllowed;
+        if (nth == pivotPos)
+            return;
+        if (nth < pivotPos)
+        {
+            last = pivotPos;
+        }
+        else
+        {
+            first = pivotPos + 1;
+            leftmost = false;
+        }
+    }
+}
+
+template<std::random_access_iterator RandomIterator, typename Compare>
+void medianOfMediansPivot(RandomIterator first, RandomIterator last, Compare& comp)
+{
+    std::ptrdiff_t groups = (last - first) / 5;
+    for (std::ptrdiff_t i = 0; i < groups; ++i)
+    {
+        auto group = first + 5 * i;
+        insertionSort(group, group + 5, comp);
+        std::iter_swap(first + i, group + 2);
+    }
+    selectImpl(first, first + groups / 2, first + groups, comp, 0, true);
+    std::iter_swap(first, first + groups / 2);
+}
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void nthElement(RandomIterator first, RandomIterator nth, RandomIterator last, Compare comp = std::less<>())
+{
+    if (nth == last || last - first <= 1)
+        return;
+    int badAllowed = std::bit_width(static_cast<std::size_t>(last - first));
+    Impl::selectImpl(first, nth, last, comp, badAllowed, true);
+}
+
+// select the i-th smallest element (0-based) of [first, last), return its position after reordering like nthElement
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+RandomIterator select(RandomIterator first, RandomIterator last, std::size_t i, Compare comp = std::less<>())
+{
+    assert(i < static_cast<std::size_t>(last - first));
+    nthElement(first, first + i, last, comp);
+    return first + i;
+}
+
+// top-k : the k smallest elements of a stream by comp (k greatest ones with std::greater<>)
+// keep a bounded D-ary max heap of the k smallest elements seen so far, an element less than the top replaces it.
+// a stream of random order replaces the top O(klog(N/k)) times, other elements are rejected by one comparison.
+// time complexity: O(Nlogk) worst, O(N + klogklog(N/k)) for random order
+// space complexity: O(k)
+template<typename T, typename Compare = std::less<>>
+class TopK
+{
+public:
+    TopK(std::size_t k, const Compare& comp = Compare()) : m_k(k), m_comp(comp)
+    {
+        m_heap.reserve(k);
+    }
+    void push(const T& value)
+    {
+        if (m_heap.size() < m_k)
+        {
+            m_heap.push_back(value);
+            pushHeap(m_heap.begin(), m_heap.end(), m_comp);
+        }
+        else if (m_k > 0 && m_comp(value, m_heap.front()))
+        {
+            Impl::heapSiftDown<4>(m_heap.begin(), 0, m_k, T(value), m_comp);
+        }
+    }
+    void push(T&& value)
+    {
+        if (m_heap.size() < m_k)
+        {
+            m_heap.push_back(std::move(value));
+            pushHeap(m_heap.begin(), m_heap.end(), m_comp);
+        }
+        else if (m_k > 0 && m_comp(value, m_heap.front()))
+        {
+            Impl::heapSiftDown<4>(m_heap.begin(), 0, m_k, std::move(value), m_comp);
+        }
+    }
+    template<std::input_iterator InputIterator>
+    void push(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+            push(*first);
+    }
+    // push all elements kept by other
+    void merge(TopK&& other)
+    {
+        for (auto& value : other.m_heap)
+            push(std::move(value));
+        other.m_heap.clear();
+    }
+    std::size_t size() const
+    {
+        return m_heap.size();
+    }
+    std::size_t capacity() const
+    {
+        return m_k;
+    }
+    // the greatest element kept, which is the k-th smallest element once k elements have been pushed
+    const T& top() const
+    {
+        assert(!m_heap.empty());
+        return m_heap.front();
+    }
+    // the kept elements sorted in ascending order by comp
+    std::vector<T> result() const
+    {
+        std::vector<T> res(m_heap);
+        sortHeap(res.begin(), res.end(), m_comp);
+        return res;
+    }
+private:
+    std::size_t m_k;
+    Compare m_comp;
+    std::vector<T> m_heap;
+};
+
+template<std::input_iterator InputIterator, typename Compare = std::less<>>
+std::vector<typename std::iterator_traits<InputIterator>::value_type> topK(InputIterator first, InputIterator last, std::size_t k, Compare comp = std::less<>())
+{
+    TopK<typename std::iterator_traits<InputIterator>::value_type, Compare> res(k, comp);
+    res.push(first, last);
+    return res.result();
+}
+
+// parallel top-k : every thread keeps the top-k of a chunk, the per-thread sets are merged at last
+// time complexity: O(N/P + Pklogk) for random order
+// space complexity: O(Pk)
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+std::vector<typename std::iterator_traits<RandomIterator>::value_type> parallelTopK(RandomIterator first, RandomIterator last, std::size_t k, Compare comp = std::less<>(), std::size_t threadCount = Impl::defaultThreadCount())
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    std::size_t N = last - first;
+    threadCount = std::max<std::size_t>(1, std::min(threadCount, N / std::max<std::size_t>(k, 1024)));
+    std::vector<TopK<value_type, Compare>> partial(threadCount, TopK<value_type, Compare>(k, comp));
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        partial[t].push(first + begin, first + end);
+    });
+    for (std::size_t t = 1; t < threadCount; ++t)
+        partial[0].merge(std::move(partial[t]));
+    return partial[0].result();
+}
+
+// indirect sorting : sort large elements by sorting their indexes, then move every element once
+// argSort returns the permutation that sorts [first, last) stably by comp on projected keys, the elements are not moved.
+// arithmetic keys are copied into (key, index) pairs which are sorted in a contiguous array, other keys are compared
+// through the projection of the indexed elements.
+// applyPermutation moves elements to their sorted positions by following the cycles of the permutation,
+// every element is moved once plus one move per cycle, visited indexes are marked by complementing them in perm,
+// and restored afterwards, so the same permutation could be applied to several parallel arrays.
+// time complexity: O(NlogN) comparisons, O(N) element moves
+// space complexity: O(N) indexes
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>, typename Projection = std::identity>
+std::vector<std::size_t> argSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>(), Projection proj = {})
+{
+    using key_type = std::remove_cvref_t<std::invoke_result_t<Projection&, typename std::iterator_traits<RandomIterator>::reference>>;
+    std::size_t N = last - first;
+    std::vector<std::size_t> perm(N);
+    if constexpr (std::is_arithmetic_v<key_type>)
+    {
+        std::vector<std::pair<key_type, std::size_t>> keys(N);
+        for (std::size_t i = 0; i < N; ++i)
+            keys[i] = {std::invoke(proj, first[i]), i};
+        quickSort(keys.begin(), keys.end(), [&comp](const auto& a, const auto& b) {
+            return comp(a.first, b.first) || (!comp(b.first, a.first) && a.second < b.second);
+        });
+        for (std::size_t i = 0; i < N; ++i)
+            perm[i] = keys[i].second;
+    }
+    else
+    {
+        std::iota(perm.begin(), perm.end(), std::size_t(0));
+        quickSort(perm.begin(), perm.end(), [&](std::size_t a, std::size_t b) {
+            const auto& keyA = std::invoke(proj, first[a]);
+            const auto& keyB = std::invoke(proj, first[b]);
+            return comp(keyA, keyB) || (!comp(keyB, keyA) && a < b);
+        });
+    }
+    return perm;
+}
+
+// reorder [first, first + perm.size()) so that the element at i is the element at perm[i] before, perm is a permutation
+template<std::random_access_iterator RandomIterator, std::ranges::random_access_range Permutation>
+    requires std::same_as<std::ranges::range_value_t<Permutation>, std::size_t>
+void applyPermutation(RandomIterator first, Permutation&& perm)
+{
+    std::size_t N = std::ranges::size(perm);
+    auto p = std::ranges::begin(perm);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (p[i] == i || (p[i] >> (std::numeric_limits<std::size_t>::digits - 1)))
+            continue;
+        auto tmp = std::move(first[i]);
+        std::size_t hole = i;
+        while (p[hole] != i)
+        {
+            std::size_t next = p[hole];
+            first[hole] = std::move(first[next]);
+            p[hole] = ~next;
+            hole = next;
+        }
+        first[hole] = std::move(tmp);
+        p[hole] = ~i;
+    }
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (p[i] >> (std::numeric_limits<std::size_t>::digits - 1))
+            p[i] = ~p[i];
+    }
+}
+
+// sort [first, last) stably by argSort and applyPermutation
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>, typename Projection = std::identity>
+void indirectSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>(), Projection proj = {})
+{
+    auto perm = argSort(first, last, comp, proj);
+    applyPermutation(first, perm);
+}
+
+// co-sort : sort the key column [keyFirst, keyLast) stably, and reorder every parallel column starting at columns the same way
+// (structure of arrays), no tuple of the columns is materialized.
+template<std::random_access_iterator KeyIterator, typename Compare, std::random_access_iterator... RandomIterators>
+void coSort(KeyIterator keyFirst, KeyIterator keyLast, Compare comp, RandomIterators... columns)
+{
+    auto perm = argSort(keyFirst, keyLast, comp);
+    applyPermutation(keyFirst, perm);
+    (applyPermutation(columns, perm), ...);
+}
+
+// parallel sample sort : super scalar sample sort (Sanders and Winkel)
+// pick k-1 splitters from a sorted random sample, distribute elements into k buckets, then sort buckets recursively.
+// the splitters are stored as an implicit binary search tree, so the bucket of an element is found by log(k) steps
+// of j = 2j + comp(tree[j], elem) without any branch, several elements are classified together to hide latency.
+// every thread classifies a chunk and counts its own buckets, then every thread moves its chunk to the buffer,
+// after that buckets are sorted by threads independently.
+// every level of recursion reads and writes input once with k = 256, which is about 2 passes for huge inputs.
+// time complexity: average O(NlogN/P)
+// space complexity: O(N)
+namespace Impl
+{
+constexpr std::size_t sampleSortBaseThreshold = 1 << 12;
+constexpr std::size_t sampleSortMaxBucketsLog = 8;
+constexpr std::size_t sampleSortOversampling = 16;
+constexpr std::size_t sampleSortUnroll = 4;
+
+// sort [sFirst, sFirst + N), the result is left in [sFirst, sFirst + N) if resultInSource, or in [dFirst, dFirst + N) otherwise.
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Compare>
+void sampleSortImpl(RandomIterator1 sFirst, RandomIterator2 dFirst, std::size_t N, bool resultInSource, Compare& comp, std::size_t threadCount, std::uint64_t seed)
+{
+    using value_type = typename std::iterator_traits<RandomIterator1>::value_type;
+    if (N <= sampleSortBaseThreshold)
+    {
+        quickSort(sFirst, sFirst + N, comp);
+        if (!resultInSource)
+            std::move(sFirst, sFirst + N, dFirst);
+        return;
+    }
+    // k buckets, at least sampleSortBaseThreshold / 4 elements a bucket on average
+    std::size_t logK = std::min<std::size_t>(sampleSortMaxBucketsLog, std::bit_width(N / (sampleSortBaseThreshold / 4)) - 1);
+    std::size_t k = std::size_t(1) << logK;
+    // sort a random sample and pick equally spaced splitters, tree[j] has children tree[2j] and tree[2j+1], tree[0] is unused
+    std::size_t sampleSize = sampleSortOversampling * k;
+    std::vector<value_type> sample;
+    sample.reserve(sampleSize);
+    for (std::size_t i = 0; i < sampleSize; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL; // linear congruential generator
+        sample.push_back(sFirst[(seed >> 33) % N]);
+    }
+    quickSort(sample.begin(), sample.end(), comp);
+    std::vector<value_type> tree(k);
+    auto buildTree = [&](auto& self, std::size_t j, std::size_t lo, std::size_t hi) -> void { // splitters lo..hi-1 under node j
+        if (j >= k)
+            return;
+        std::size_t mid = (lo + hi) / 2;
+        tree[j] = sample[mid * sampleSortOversampling];
+        self(self, 2 * j, lo, mid);
+        self(self, 2 * j + 1, mid + 1, hi);
+    };
+    buildTree(buildTree, 1, 1, k);
+    auto classify = [&](std::size_t begin, std::size_t end, std::uint8_t* oracle, std::size_t* counts) {
+        std::size_t i = begin;
+        for (; i + sampleSortUnroll <= end; i += sampleSortUnroll)
+        {
+            std::size_t j[sampleSortUnroll];
+            std::fill(j, j + sampleSortUnroll, std::size_t(1));
+            for (std::size_t level = 0; level < logK; ++level)
+            {
+                for (std::size_t u = 0; u < sampleSortUnroll; ++u)
+                {
+                    j[u] = 2 * j[u] + static_cast<std::size_t>(static_cast<bool>(comp(tree[j[u]], sFirst[i + u])));
+                }
+            }
+            for (std::size_t u = 0; u < sampleSortUnroll; ++u)
+            {
+                oracle[i + u] = static_cast<std::uint8_t>(j[u] - k);
+                counts[j[u] - k]++;
+            }
+        }
+        for (; i < end; ++i)
+        {
+            std::size_t j = 1;
+            for (std::size_t level = 0; level < logK; ++level)
+            {
+                j = 2 * j + static_cast<std::size_t>(static_cast<bool>(comp(tree[j], sFirst[i])));
+            }
+            oracle[i] = static_cast<std::uint8_t>(j - k);
+            counts[j - k]++;
+        }
+    };
+    // classify and count per thread, prefix sum in (bucket, thread) order, then scatter per thread
+    std::vector<std::uint8_t> oracle(N);
+    std::size_t chunks = std::max<std::size_t>(1, std::min(threadCount, N / sampleSortBaseThreshold));
+    std::vector<std::size_t> offsets(chunks * k, 0);
+    parallelFor(N, chunks, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        classify(begin, end, oracle.data(), offsets.data() + t * k);
+    });
+    std::vector<std::size_t> bucketStarts(k + 1);
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < k; ++b)
+    {
+        bucketStarts[b] = sum;
+        for (std::size_t t = 0; t < chunks; ++t)
+        {
+            std::size_t count = offsets[t * k + b];
+            offsets[t * k + b] = sum;
+            sum += count;
+        }
+    }
+    bucketStarts[k] = N;
+    if (std::adjacent_find(bucketStarts.begin(), bucketStarts.end(), [N](std::size_t a, std::size_t b) { return b - a == N; }) != bucketStarts.end())
+    {
+        // all elements are in one bucket (too many equal elements), no progress, quick sort handles it well
+        quickSort(sFirst, sFirst + N, comp);
+        if (!resultInSource)
+            std::move(sFirst, sFirst + N, dFirst);
+        return;
+    }
+    parallelFor(N, chunks, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = offsets.data() + t * k;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            dFirst[local[oracle[i]]++] = std::move(sFirst[i]);
+        }
+    });
+    std::vector<std::uint8_t>().swap(oracle); // free it before buckets take their own, at most N bytes of oracles at any time
+    // buckets are in destination now, sort them by threads, larger buckets first
+    std::vector<std::size_t> order(k);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return bucketStarts[a+1] - bucketStarts[a] > bucketStarts[b+1] - bucketStarts[b];
+    });
+    std::atomic<std::size_t> next = 0;
+    parallelRun(std::min(threadCount, k), [&](std::size_t t) {
+        for (std::size_t i = next++; i < k; i = next++)
+        {
+            std::size_t b = order[i];
+            std::size_t begin = bucketStarts[b];
+            sampleSortImpl(dFirst + begin, sFirst + begin, bucketStarts[b+1] - begin, !resultInSource, comp, 1, seed + t * k + b);
+        }
+    });
+}
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator, typename Compare = std::less<>>
+void parallelSampleSort(RandomIterator first, RandomIterator last, Compare comp = std::less<>(), std::size_t threadCount = Impl::defaultThreadCount())
+{
+    std::size_t N = last - first;
+    if (N <= Impl::sampleSortBaseThreshold)
+    {
+        quickSort(first, last, comp);
+        return;
+    }
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    std::vector<value_type> buffer;
+    buffer.reserve(N);
+    std::move(first, last, std::back_inserter(buffer));
+    Impl::sampleSortImpl(buffer.begin(), first, N, false, comp, std::max<std::size_t>(1, threadCount), N);
+}
+
+// counting sort
+// time complexity: O(k+N), k is the upper bound of the range, N is input scale
+template<std::random_access_iterator RandomIterator> requires std::integral<typename std::iterator_traits<RandomIterator>::value_type>
+void countingSort(RandomIterator first, RandomIterator last, int K)
+{
+    std::vector<std::size_t> vec(K+1, 0);
+    for (auto iter = first; iter < last; ++iter)
+    {
+        vec[*iter]++;
+    }
+    for (int i = K; i >= 0;)
+    {
+        if (vec[i] > 0)
+        {
+            *(--last) = i;
+            vec[i]--;
+        }
+        else
+        {
+            --i;
+        }
+    }
+}
+
+// stable counting sort of elements by integral keys projected from them, keys must be in [minKey, maxKey]
+// with threadCount > 1, every thread counts a chunk of input into its own histogram, the histograms are merged by
+// a prefix sum in (key, thread) order, then every thread moves its chunk to the final positions.
+// time complexity: O(k*P+N), k is maxKey-minKey+1, P is thread count
+// space complexity: O(k*P+N)
+template<std::random_access_iterator RandomIterator, std::integral Key, typename Projection = std::identity>
+    requires std::integral<std::remove_cvref_t<std::invoke_result_t<Projection&, typename std::iterator_traits<RandomIterator>::value_type&>>>
+void countingSort(RandomIterator first, RandomIterator last, Key minKey, Key maxKey, Projection proj = {}, std::size_t threadCount = 1)
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    assert(minKey <= maxKey);
+    std::size_t N = last - first;
+    if (N <= 1)
+        return;
+    auto index = [&proj, minKey](const value_type& value) -> std::size_t {
+        return static_cast<std::size_t>(static_cast<std::uintmax_t>(std::invoke(proj, value)) - static_cast<std::uintmax_t>(minKey));
+    };
+    std::size_t K = static_cast<std::size_t>(static_cast<std::uintmax_t>(maxKey) - static_cast<std::uintmax_t>(minKey)) + 1;
+    threadCount = std::max<std::size_t>(1, std::min(threadCount, N));
+    std::vector<value_type> buffer;
+    buffer.reserve(N);
+    std::move(first, last, std::back_inserter(buffer));
+    // offsets[t * K + k]: the next position of key k in chunk of thread t
+    std::vector<std::size_t> offsets(threadCount * K, 0);
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = offsets.data() + t * K;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            assert(std::invoke(proj, buffer[i]) >= minKey && std::invoke(proj, buffer[i]) <= maxKey);
+            local[index(buffer[i])]++;
+        }
+    });
+    std::size_t sum = 0;
+    for (std::size_t k = 0; k < K; ++k)
+    {
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            std::size_t count = offsets[t * K + k];
+            offsets[t * K + k] = sum;
+            sum += count;
+        }
+    }
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = offsets.data() + t * K;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            first[local[index(buffer[i])]++] = std::move(buffer[i]);
+        }
+    });
+}
+
+// radix sort : stable least significant digit (LSD) radix sort on keys projected from elements
+// key type could be any integral or floating-point type (float, double), keys are mapped to unsigned integers
+// of the same order by bit twiddling, then sorted 8 bits a pass from the lowest digit to the highest digit.
+// -0.0 and +0.0 are the same key, so their elements keep the input order,
+// NaNs go after +inf, or before -inf if their sign bit is set.
+// histograms of all digits are computed in one pass, digits that are identical for all keys are skipped.
+// with threadCount > 1, every pass counts and scatters chunks of the input concurrently.
+// time complexity: O(d(N+k)), d is the number of digits (sizeof key type), k is 256
+// space complexity: O(N)
+namespace Impl
+{
+template<typename T>
+concept RadixSortKey = (std::integral<T> && !std::same_as<T, bool>) || (std::floating_point<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+
+// map a key to an unsigned integer that has the same order
+template<RadixSortKey Key>
+auto radixKeyToUnsigned(Key key)
+{
+    if constexpr (std::floating_point<Key>)
+    {
+        using Unsigned = std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+        constexpr Unsigned signBit = Unsigned(1) << (sizeof(Unsigned) * 8 - 1);
+        if (key == Key(0)) // -0.0 == +0.0
+            key = Key(0);
+        Unsigned bits = std::bit_cast<Unsigned>(key);
+        // negative: flip all bits, positive: flip sign bit only
+        return bits ^ (static_cast<Unsigned>(-(bits >> (sizeof(Unsigned) * 8 - 1))) | signBit);
+    }
+    else
+    {
+        using Unsigned = std::make_unsigned_t<Key>;
+        Unsigned bits = static_cast<Unsigned>(key);
+        if constexpr (std::is_signed_v<Key>)
+        {
+            bits ^= Unsigned(1) << (sizeof(Unsigned) * 8 - 1);
+        }
+        return bits;
+    }
+}
+
+constexpr std::size_t radixBits = 8;
+constexpr std::size_t radixBuckets = std::size_t(1) << radixBits;
+
+template<typename Projection, typename Value>
+std::size_t radixDigit(Projection& proj, const Value& value, std::size_t shift)
+{
+    return static_cast<std::size_t>((radixKeyToUnsigned(std::invoke(proj, value)) >> shift) & (radixBuckets - 1));
+}
+
+// move [sFirst, sLast) into dFirst, element goes to dFirst[offsets[digit]++]
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Projection>
+void radixScatter(RandomIterator1 sFirst, RandomIterator1 sLast, RandomIterator2 dFirst, std::size_t shift, std::size_t* offsets, Projection& proj)
+{
+    for (; sFirst != sLast; ++sFirst)
+    {
+        dFirst[offsets[radixDigit(proj, *sFirst, shift)]++] = std::move(*sFirst);
+    }
+}
+
+// one radix pass from [sFirst, sFirst + N) to dFirst
+// counts: histogram of this digit over the whole input, used directly when running sequentially
+template<std::random_access_iterator RandomIterator1, std::random_access_iterator RandomIterator2, typename Projection>
+void radixPass(RandomIterator1 sFirst, std::size_t N, RandomIterator2 dFirst, std::size_t shift, const std::size_t* counts, Projection& proj, std::size_t threadCount)
+{
+    if (threadCount <= 1)
+    {
+        std::size_t offsets[radixBuckets];
+        std::exclusive_scan(counts, counts + radixBuckets, offsets, std::size_t(0));
+        radixScatter(sFirst, sFirst + N, dFirst, shift, offsets, proj);
+        return;
+    }
+    // per-thread histograms of per-thread chunks, the offset of (bucket, thread) is
+    // the number of elements in smaller buckets plus the elements of this bucket in chunks of smaller thread indexes.
+    threadCount = std::min(threadCount, N);
+    std::vector<std::size_t> offsets(threadCount * radixBuckets, 0);
+    parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = offsets.data() + t * radixBuckets;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            local[radixDigit(proj, sFirst[i], shift)]++;
+        }
+    });
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < radixBuckets; ++b)
+    {
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            std::size_t count = offsets[t * radixBuckets + b];
+            offsets[t * radixBuckets + b] = sum;
+            sum += count;
+        }
+    }
+    parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        radixScatter(sFirst + begin, sFirst + end, dFirst, shift, offsets.data() + t * radixBuckets, proj);
+    });
+}
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator, typename Projection = std::identity>
+    requires Impl::RadixSortKey<std::remove_cvref_t<std::invoke_result_t<Projection&, typename std::iterator_traits<RandomIterator>::value_type&>>>
+void radixSort(RandomIterator first, RandomIterator last, Projection proj = {}, std::size_t threadCount = 1)
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    using key_type = std::remove_cvref_t<std::invoke_result_t<Projection&, value_type&>>;
+    constexpr std::size_t digits = sizeof(key_type) * 8 / Impl::radixBits;
+    std::size_t N = last - first;
+    if (N <= 1)
+        return;
+    // histograms of all digits in one pass
+    std::vector<std::size_t> counts(digits * Impl::radixBuckets, 0);
+    threadCount = std::max<std::size_t>(1, std::min(threadCount, N));
+    std::vector<std::size_t> localCounts(threadCount * digits * Impl::radixBuckets, 0);
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = localCounts.data() + t * digits * Impl::radixBuckets;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            auto key = Impl::radixKeyToUnsigned(std::invoke(proj, first[i]));
+            for (std::size_t d = 0; d < digits; ++d)
+            {
+                local[d * Impl::radixBuckets + ((key >> (d * Impl::radixBits)) & (Impl::radixBuckets - 1))]++;
+            }
+        }
+    });
+    for (std::size_t t = 0; t < threadCount; ++t)
+    {
+        std::transform(counts.begin(), counts.end(), localCounts.begin() + t * counts.size(), counts.begin(), std::plus<>());
+    }
+    auto firstKey = Impl::radixKeyToUnsigned(std::invoke(proj, *first));
+    // data is moved to buffer first, then moved back and forth between buffer and input range
+    std::vector<value_type> buffer;
+    buffer.reserve(N);
+    std::move(first, last, std::back_inserter(buffer));
+    bool inBuffer = true;
+    for (std::size_t d = 0; d < digits; ++d)
+    {
+        const std::size_t* digitCounts = counts.data() + d * Impl::radixBuckets;
+        if (digitCounts[(firstKey >> (d * Impl::radixBits)) & (Impl::radixBuckets - 1)] == N) // all keys have the same digit
+            continue;
+        if (inBuffer)
+            Impl::radixPass(buffer.begin(), N, first, d * Impl::radixBits, digitCounts, proj, threadCount);
+        else
+            Impl::radixPass(first, N, buffer.begin(), d * Impl::radixBits, digitCounts, proj, threadCount);
+        inBuffer = !inBuffer;
+    }
+    if (inBuffer)
+    {
+        std::move(buffer.begin(), buffer.end(), first);
+    }
+}
+
+// MSD radix sort for strings : American flag sort (McIlroy, Bostic and McIlroy)
+// sort a range of string-like elements (std::string, std::string_view, ...) in lexicographical order of unsigned chars.
+// elements are distributed into 257 buckets (end of string and 256 chars) by the char at current depth in place,
+// by following permutation cycles, then every bucket is sorted on the next char.
+// small buckets are sorted by multikey quicksort (Bentley and Sedgewick): 3-way partition on the char at current depth.
+// when all elements of a bucket share the next chars, the whole common prefix is skipped in one scan.
+// chars before the distinguishing prefix of an element are examined only a constant number of times.
+// time complexity: O(S + N), S is total length of distinguishing prefixes
+// space complexity: O(D), D is the length of the longest distinguishing prefix, inplace sorting
+namespace Impl
+{
+template<typename T>
+concept RadixSortString = requires(const T& str, std::size_t i)
+{
+    { str.size() } -> std::convertible_to<std::size_t>;
+    { str[i] } -> std::convertible_to<unsigned char>;
+} && sizeof(std::remove_cvref_t<decltype(std::declval<const T&>()[0])>) == 1;
+
+constexpr std::size_t stringRadixBuckets = 257;
+constexpr std::ptrdiff_t stringRadixThreshold = 32;
+constexpr std::ptrdiff_t multikeyInsertionThreshold = 8;
+
+// char at depth of str plus 1, 0 if str is shorter
+template<RadixSortString String>
+std::size_t stringRadixChar(const String& str, std::size_t depth)
+{
+    return depth < static_cast<std::size_t>(str.size()) ? static_cast<std::size_t>(static_cast<unsigned char>(str[depth])) + 1 : 0;
+}
+
+// compare two strings from depth, the first depth chars are known to be equal
+template<RadixSortString String>
+bool stringSuffixLess(const String& a, const String& b, std::size_t depth)
+{
+    for (;; ++depth)
+    {
+        std::size_t ca = stringRadixChar(a, depth);
+        std::size_t cb = stringRadixChar(b, depth);
+        if (ca != cb)
+            return ca < cb;
+        if (ca == 0)
+            return false;
+    }
+}
+
+// multikey quicksort [first, last), all elements have the same first depth chars
+template<std::random_access_iterator RandomIterator>
+void multikeyQuickSort(RandomIterator first, RandomIterator last, std::size_t depth)
+{
+    while (last - first > 1)
+    {
+        if (last - first < multikeyInsertionThreshold)
+        {
+            insertionSort(first, last, [depth](const auto& a, const auto& b) { return stringSuffixLess(a, b, depth); });
+            return;
+        }
+        // median of 3 chars as pivot
+        std::size_t a = stringRadixChar(*first, depth);
+        std::size_t b = stringRadixChar(*(first + (last - first) / 2), depth);
+        std::size_t c = stringRadixChar(*(last - 1), depth);
+        std::size_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        // 3-way partition: [first, lt) < pivot, [lt, gt) == pivot, [gt, last) > pivot
+        auto lt = first, gt = last, iter = first;
+        while (iter < gt)
+        {
+            std::size_t ch = stringRadixChar(*iter, depth);
+            if (ch < pivot)
+                std::iter_swap(lt++, iter++);
+            else if (ch > pivot)
+                std::iter_swap(iter, --gt);
+            else
+                ++iter;
+        }
+        multikeyQuickSort(first, lt, depth);
+        multikeyQuickSort(gt, last, depth);
+        if (pivot == 0) // strings in the middle part are all ended, they are equal
+            return;
+        first = lt;
+        last = gt;
+        ++depth;
+    }
+}
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator> requires Impl::RadixSortString<typename std::iterator_traits<RandomIterator>::value_type>
+void msdRadixSort(RandomIterator first, RandomIterator last)
+{
+    struct Task
+    {
+        RandomIterator first;
+        RandomIterator last;
+        std::size_t depth;
+    };
+    std::vector<Task> tasks{{first, last, 0}};
+    while (!tasks.empty())
+    {
+        auto [lo, hi, depth] = tasks.back();
+        tasks.pop_back();
+        if (hi - lo < Impl::stringRadixThreshold)
+        {
+            Impl::multikeyQuickSort(lo, hi, depth);
+            continue;
+        }
+        std::size_t counts[Impl::stringRadixBuckets] = {};
+        for (auto iter = lo; iter != hi; ++iter)
+        {
+            counts[Impl::stringRadixChar(*iter, depth)]++;
+        }
+        std::size_t firstChar = Impl::stringRadixChar(*lo, depth);
+        if (counts[firstChar] == static_cast<std::size_t>(hi - lo)) // all elements have the same char
+        {
+            if (firstChar != 0)
+            {
+                // skip the whole common prefix at once instead of one char per pass
+                std::size_t prefix = static_cast<std::size_t>(lo->size());
+                for (auto iter = lo + 1; iter != hi && prefix > depth + 1; ++iter)
+                {
+                    std::size_t i = depth + 1;
+                    while (i < prefix && i < static_cast<std::size_t>(iter->size()) && (*lo)[i] == (*iter)[i])
+                        ++i;
+                    prefix = i;
+                }
+                tasks.push_back({lo, hi, prefix});
+            }
+            continue;
+        }
+        // next[b]: the next unplaced position of bucket b, ends[b]: end position of bucket b
+        std::size_t next[Impl::stringRadixBuckets];
+        std::size_t ends[Impl::stringRadixBuckets];
+        std::exclusive_scan(counts, counts + Impl::stringRadixBuckets, next, std::size_t(0));
+        std::inclusive_scan(counts, counts + Impl::stringRadixBuckets, ends);
+        // permute in place: move the element at the next position of bucket b to its own bucket, until an element of bucket b comes
+        for (std::size_t b = 0; b < Impl::stringRadixBuckets; ++b)
+        {
+            while (next[b] < ends[b])
+            {
+                std::size_t ch = Impl::stringRadixChar(lo[next[b]], depth);
+                while (ch != b)
+                {
+                    std::iter_swap(lo + next[b], lo + next[ch]++);
+                    ch = Impl::stringRadixChar(lo[next[b]], depth);
+                }
+                next[b]++;
+            }
+        }
+        // strings in bucket 0 are all ended, they are equal
+        for (std::size_t b = 1; b < Impl::stringRadixBuckets; ++b)
+        {
+            if (counts[b] > 1)
+            {
+                tasks.push_back({lo + (ends[b] - counts[b]), lo + ends[b], depth + 1});
+            }
+        }
+    }
+}
+
+// bucket sort : for arithmetic values of roughly uniform or smooth distribution, sort in ascending order
+// bucket boundaries are equal-depth splitters picked from a sorted sample of input, so skewed inputs still get balanced buckets.
+// duplicated splitters are merged, a value that takes several splitters (a heavy key) gets an equality bucket of its own,
+// which needs no sorting, so heavily duplicated inputs do not end up in one huge bucket.
+// a bucket index is found by looking up a uniform grid over [min, max] for the splitters in the cell of the value,
+// followed by a binary search among them, which is O(1) expected for smooth distributions and O(logB) at most.
+// all buckets are placed in one contiguous arena (count, prefix sum, scatter) instead of per-bucket vectors,
+// tiny buckets are sorted by insertion sort, others by quick sort, buckets are sorted by threadCount threads.
+// values must not be NaN, ranges with infinities are sorted by quick sort.
+// time complexity: O(N) expected for smooth distributions, O(NlogN) worst
+// space complexity: O(N)
+namespace Impl
+{
+constexpr std::size_t bucketSortTargetSize = 16;
+constexpr std::size_t bucketSortMaxBuckets = std::size_t(1) << 16;
+constexpr std::size_t bucketSortInsertionThreshold = 32;
+} // namespace Impl
+
+template<std::random_access_iterator RandomIterator> requires std::is_arithmetic_v<typename std::iterator_traits<RandomIterator>::value_type>
+void bucketSort(RandomIterator first, RandomIterator last, std::size_t threadCount = 1)
+{
+    using value_type = typename std::iterator_traits<RandomIterator>::value_type;
+    std::size_t N = last - first;
+    if (N <= Impl::bucketSortInsertionThreshold)
+    {
+        insertionSort(first, last);
+        return;
+    }
+    if constexpr (std::is_floating_point_v<value_type>)
+    {
+        assert(std::none_of(first, last, [](value_type value) { return value != value; }) && "bucketSort: NaN is not allowed");
+    }
+    auto [minIter, maxIter] = std::minmax_element(first, last);
+    double lo = static_cast<double>(*minIter);
+    double hi = static_cast<double>(*maxIter);
+    if (!(lo < hi)) // all elements are equal
+        return;
+    if (!std::isfinite(hi - lo)) // infinities, no grid over the range
+    {
+        quickSort(first, last);
+        return;
+    }
+    // equal-depth splitters from a sorted sample, merged to unique values
+    std::size_t candidates = std::clamp(N / Impl::bucketSortTargetSize, std::size_t(2), Impl::bucketSortMaxBuckets);
+    std::size_t sampleSize = std::min(N, 4 * candidates);
+    std::vector<value_type> sample(sampleSize);
+    for (std::size_t i = 0; i < sampleSize; ++i)
+    {
+        sample[i] = first[i * N / sampleSize];
+    }
+    quickSort(sample.begin(), sample.end());
+    std::vector<value_type> splitters;
+    std::vector<bool> heavy; // the splitter was picked more than once
+    for (std::size_t i = 1; i < candidates; ++i)
+    {
+        value_type splitter = sample[i * sampleSize / candidates];
+        if (!splitters.empty() && splitters.back() == splitter)
+        {
+            heavy.back() = true;
+        }
+        else
+        {
+            splitters.push_back(splitter);
+            heavy.push_back(false);
+        }
+    }
+    // with M unique splitters, range bucket i holds values x that splitters[i-1] < x <= splitters[i] (i <= M),
+    // except x == splitters[i] of a heavy splitter, which goes to the equality bucket right after range bucket i.
+    // a heavy splitter takes at least two candidates, so B <= candidates buckets.
+    std::size_t M = splitters.size();
+    std::vector<std::uint16_t> rangeBucket(M + 1), equalBucket(M);
+    std::vector<bool> equalBuckets;
+    for (std::size_t i = 0; i <= M; ++i)
+    {
+        rangeBucket[i] = static_cast<std::uint16_t>(equalBuckets.size());
+        equalBuckets.push_back(false);
+        if (i < M && heavy[i])
+        {
+            equalBucket[i] = static_cast<std::uint16_t>(equalBuckets.size());
+            equalBuckets.push_back(true);
+        }
+    }
+    std::size_t B = equalBuckets.size();
+    // grid[g]: number of splitters that fall into cells before g, all of them are less than any value in cell g
+    std::size_t G = 2 * candidates;
+    double scale = static_cast<double>(G) / (hi - lo);
+    auto cell = [lo, scale, G](value_type value) -> std::size_t {
+        double position = (static_cast<double>(value) - lo) * scale;
+        return position >= 0 && position < static_cast<double>(G) ? static_cast<std::size_t>(position) : (position < 0 ? 0 : G - 1);
+    };
+    std::vector<std::size_t> grid(G + 1, 0);
+    for (const auto& splitter : splitters)
+    {
+        grid[cell(splitter) + 1]++;
+    }
+    std::partial_sum(grid.begin(), grid.end(), grid.begin());
+    auto bucketOf = [&](value_type value) -> std::size_t {
+        std::size_t g = cell(value);
+        std::size_t i = std::lower_bound(splitters.begin() + grid[g], splitters.begin() + grid[g+1], value) - splitters.begin();
+        return i < M && heavy[i] && !(value < splitters[i]) ? equalBucket[i] : rangeBucket[i];
+    };
+    // count and scatter into the arena
+    threadCount = std::max<std::size_t>(1, std::min(threadCount, N / B + 1));
+    // bucket indexes are computed once and kept for scattering
+    std::vector<std::uint16_t> bucketIndexes(N);
+    static_assert(Impl::bucketSortMaxBuckets - 1 <= std::numeric_limits<std::uint16_t>::max());
+    std::vector<std::size_t> offsets(threadCount * B, 0);
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = offsets.data() + t * B;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            bucketIndexes[i] = static_cast<std::uint16_t>(bucketOf(first[i]));
+            local[bucketIndexes[i]]++;
+        }
+    });
+    std::vector<std::size_t> bucketStarts(B + 1, 0);
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < B; ++b)
+    {
+        bucketStarts[b] = sum;
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            std::size_t count = offsets[t * B + b];
+            offsets[t * B + b] = sum;
+            sum += count;
+        }
+    }
+    bucketStarts[B] = N;
+    std::unique_ptr<value_type[]> arena(new value_type[N]); // no value initialization, every slot is written by scattering
+    Impl::parallelFor(N, threadCount, [&](std::size_t t, std::size_t begin, std::size_t end) {
+        std::size_t* local = offsets.data() + t * B;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            arena[local[bucketIndexes[i]]++] = first[i];
+        }
+    });
+    // sort every bucket and copy back, a thread takes the buckets that start in its chunk of [0, N)
+    Impl::parallelFor(N, threadCount, [&](std::size_t, std::size_t begin, std::size_t end) {
+        std::size_t bBegin = std::lower_bound(bucketStarts.begin(), bucketStarts.begin() + B, begin) - bucketStarts.begin();
+        std::size_t bEnd = std::lower_bound(bucketStarts.begin(), bucketStarts.begin() + B, end) - bucketStarts.begin();
+        for (std::size_t b = bBegin; b < bEnd; ++b)
+        {
+            value_type* bFirst = arena.get() + bucketStarts[b];
+            value_type* bLast = arena.get() + bucketStarts[b+1];
+            if (!equalBuckets[b]) // an equality bucket is already sorted
+            {
+                if (bLast - bFirst <= static_cast<std::ptrdiff_t>(Impl::bucketSortInsertionThreshold))
+                    insertionSort(bFirst, bLast);
+                else
+                    quickSort(bFirst, bLast);
+            }
+            std::copy(bFirst, bLast, first + bucketStarts[b]);
+        }
+    });
+}
+
+// external merge sort : sort a binary file of fixed-size records that may not fit in memory
+// 1. run generation: read as many records as fit in memoryBudget at a time, sort them in memory, write them to a temporary run file,
+//    with threadCount > 1 they are sorted by sample sort, whose scratch buffer and bucket indexes take part of the budget.
+// 2. merge: merge at most fanIn runs at a time by a loser tree, with one large sequential buffer per run and one for output,
+//    until one run is left, the last merge writes to the output file directly.
+// fanIn is the number of runs whose buffers of at least minBufferSize bytes fit in memoryBudget.
+// records must be trivially copyable and default constructible, they are read and written as raw bytes in native layout.
+// throw std::runtime_error on I/O failure, temporary files are removed in any case.
+// time complexity: O(NlogN) comparisons, O(N/B * log_fanIn(N/M)) block I/Os, M is memory budget, B is buffer size
+// space complexity: O(M) memory, O(N) temporary disk space
+struct ExternalSortOptions
+{
+    std::size_t memoryBudget = std::size_t(256) << 20;                           // bytes of all record buffers (runs, sort scratch, merge)
+    std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(); // where run files are written
+    std::size_t minBufferSize = std::size_t(1) << 20;                             // minimum bytes of a merge buffer
+    std::size_t threadCount = 1;                                                  // threads used to sort a run
+};
+
+namespace Impl
+{
+// sequential reader of records from a file with a large buffer
+template<typename Record>
+class RecordReader
+{
+public:
+    RecordReader(const std::filesystem::path& path, std::size_t bufferRecords)
+        : m_file(path, std::ios::binary)
+        , m_path(path)
+        , m_buffer(std::max<std::size_t>(1, bufferRecords))
+    {
+        if (!m_file)
+            throw std::runtime_error("externalSort: can not open " + path.string());
+        refill();
+    }
+    bool empty() const
+    {
+        return m_pos == m_size;
+    }
+    const Record& front() const
+    {
+        return m_buffer[m_pos];
+    }
+    void pop()
+    {
+        if (++m_pos == m_size)
+            refill();
+    }
+    // read up to count records into out, return the number of records read
+    std::size_t read(Record* out, std::size_t count)
+    {
+        std::size_t total = 0;
+        while (total < count && !empty())
+        {
+            std::size_t n = std::min(count - total, m_size - m_pos);
+            std::copy(m_buffer.begin() + m_pos, m_buffer.begin() + (m_pos + n), out + total);
+            total += n;
+            m_pos += n;
+            if (m_pos == m_size)
+                refill();
+        }
+        return total;
+    }
+private:
+    void refill()
+    {
+        m_file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size() * sizeof(Record)));
+        std::size_t bytes = static_cast<std::size_t>(m_file.gcount());
+        if (m_file.bad() || bytes % sizeof(Record) != 0)
+            throw std::runtime_error("externalSort: bad record file " + m_path.string());
+        m_pos = 0;
+        m_size = bytes / sizeof(Record);
+    }
+    std::ifstream m_file;
+    std::filesystem::path m_path;
+    std::vector<Record> m_buffer;
+    std::size_t m_pos = 0;
+    std::size_t m_size = 0;
+};
+
+// sequential writer of records to a file with a large buffer
+template<typename Record>
+class RecordWriter
+{
+public:
+    RecordWriter(const std::filesystem::path& path, std::size_t bufferRecords)
+        : m_file(path, std::ios::binary | std::ios::trunc)
+        , m_path(path)
+    {
+        if (!m_file)
+            throw std::runtime_error("externalSort: can not open " + path.string());
+        m_buffer.reserve(std::max<std::size_t>(1, bufferRecords));
+    }
+    void push(const Record& record)
+    {
+        m_buffer.push_back(record);
+        if (m_buffer.size() == m_buffer.capacity())
+            flush();
+    }
+    void write(const Record* records, std::size_t count)
+    {
+        flush();
+        writeBytes(records, count);
+    }
+    void close()
+    {
+        flush();
+        m_file.close();
+        if (!m_file)
+            throw std::runtime_error("externalSort: can not write " + m_path.string());
+    }
+private:
+    void flush()
+    {
+        writeBytes(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+    void writeBytes(const Record* records, std::size_t count)
+    {
+        m_file.write(reinterpret_cast<const char*>(records), static_cast<std::streamsize>(count * sizeof(Record)));
+        if (!m_file)
+            throw std::runtime_error("externalSort: can not write " + m_path.string());
+    }
+    std::ofstream m_file;
+    std::filesystem::path m_path;
+    std::vector<Record> m_buffer;
+};
+
+// remove all temporary run files on destruction
+struct TemporaryFiles
+{
+    ~TemporaryFiles()
+    {
+        for (const auto& path : paths)
+        {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    }
+    std::vector<std::filesystem::path> paths;
+};
+
+// merge sorted record files into output
+template<typename Record, typename Compare>
+void mergeRecordFiles(const std::vector<std::filesystem::path>& inputs, const std::filesystem::path& output, Compare& comp, std::size_t bufferRecords)
+{
+    std::vector<RecordReader<Record>> readers;
+    readers.reserve(inputs.size());
+    for (const auto& path : inputs)
+    {
+        readers.emplace_back(path, bufferRecords);
+    }
+    RecordWriter<Record> writer(output, bufferRecords);
+    auto less = [&](std::size_t a, std::size_t b) {
+        if (readers[a].empty())
+            return false;
+        if (readers[b].empty())
+            return true;
+        return comp(readers[a].front(), readers[b].front());
+    };
+    LoserTree<decltype(less)> tree(readers.size(), less);
+    for (std::size_t w = tree.winner(); !readers[w].empty(); w = tree.winner())
+    {
+        writer.push(readers[w].front());
+        readers[w].pop();
+        tree.replay();
+    }
+    writer.close();
+}
+} // namespace Impl
+
+template<typename Record, typename Compare = std::less<>> requires std::is_trivially_copyable_v<Record> && std::is_default_constructible_v<Record>
+void externalSort(const std::filesystem::path& input, const std::filesystem::path& output, Compare comp = std::less<>(), const ExternalSortOptions& options = ExternalSortOptions())
+{
+    std::size_t memoryRecords = std::max<std::size_t>(2, options.memoryBudget / sizeof(Record));
+    std::size_t minBufferRecords = std::max<std::size_t>(1, options.minBufferSize / sizeof(Record));
+    std::size_t fanIn = std::max<std::size_t>(2, memoryRecords / minBufferRecords - 1);
+    std::size_t mergeBufferRecords = memoryRecords / (fanIn + 1);
+    Impl::TemporaryFiles temporaries;
+    std::string prefix = "clrs_external_sort_" + std::to_string(std::random_device()()) + "_";
+    auto newRunPath = [&]() {
+        temporaries.paths.push_back(options.tempDirectory / (prefix + std::to_string(temporaries.paths.size()) + ".run"));
+        return temporaries.paths.back();
+    };
+    // run generation
+    std::vector<std::filesystem::path> runs;
+    {
+        Impl::RecordReader<Record> reader(input, mergeBufferRecords);
+        // sample sort takes a scratch record and a 1-byte bucket index for every record of the run
+        std::size_t runBytes = (memoryRecords - mergeBufferRecords) * sizeof(Record);
+        std::size_t runRecords = options.threadCount > 1 ? runBytes / (2 * sizeof(Record) + 1) : runBytes / sizeof(Record);
+        std::vector<Record> records(std::max<std::size_t>(1, runRecords));
+        std::vector<Record> scratch(options.threadCount > 1 ? records.size() : 0);
+        while (!reader.empty())
+        {
+            std::size_t count = reader.read(records.data(), records.size());
+            if (options.threadCount > 1)
+                Impl::sampleSortImpl(records.begin(), scratch.begin(), count, true, comp, options.threadCount, count);
+            else
+                quickSort(records.begin(), records.begin() + count, comp);
+            bool last = runs.empty() && reader.empty(); // everything fits in memory
+            Impl::RecordWriter<Record> writer(last ? output : newRunPath(), 0);
+            writer.write(records.data(), count);
+            writer.close();
+            if (last)
+                return;
+            runs.push_back(temporaries.paths.back());
+        }
+    }
+    if (runs.empty()) // empty input
+    {
+        Impl::RecordWriter<Record>(output, 0).close();
+        return;
+    }
+    // merge passes: merge the first fanIn runs into a new run, until all runs fit in one merge
+    std::size_t next = 0;
+    while (runs.size() - next > fanIn)
+    {
+        std::vector<std::filesystem::path> group(runs.begin() + next, runs.begin() + (next + fanIn));
+        next += fanIn;
+        runs.push_back(newRunPath());
+        Impl::mergeRecordFiles<Record>(group, runs.back(), comp, mergeBufferRecords);
+        for (const auto& path : group)
+        {
+            std::filesystem::remove(path);
         }
     }
+    Impl::mergeRecordFiles<Record>(std::vector<std::filesystem::path>(runs.begin() + next, runs.end()), output, comp, mergeBufferRecords);
 }
 
 } // namespace CLRS
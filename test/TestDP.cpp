@@ -3,7 +3,15 @@
 #include <iterator>
 #include <vector>
 #include <sstream>
+#include <list>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <functional>
 #include <DP.hpp>
+#include <Tree.hpp>
 
 void testDP(DetailFlag detail)
 {
@@ -13,6 +21,58 @@ void testDP(DetailFlag detail)
         std::vector<int> vec{12, -3, -25, 20, -3, -16, -23, 18, 20, -7, 12, -5, -22, 15, -4, 7};
         auto result = CLRS::maximumSubArray(vec.begin(), vec.end());
         util.assertEqual(result, 43);
+        auto [begin, end, sum] = CLRS::maximumSubArrayRange(vec.begin(), vec.end());
+        util.assertEqual(begin - vec.begin(), 7);
+        util.assertEqual(end - vec.begin(), 11);
+        util.assertEqual(sum, 43);
+        // best subarray at the second element, all negative, single element
+        std::vector<int> vec2{-2, 7, -10, 1};
+        util.assertEqual(CLRS::maximumSubArray(vec2.begin(), vec2.end()), 7);
+        std::vector<int> vec3{-5, -2, -7};
+        auto [begin3, end3, sum3] = CLRS::maximumSubArrayRange(vec3.begin(), vec3.end());
+        util.assertEqual(begin3 - vec3.begin(), 1);
+        util.assertEqual(end3 - vec3.begin(), 2);
+        util.assertEqual(sum3, -2);
+        std::list<int> lst{3};
+        util.assertEqual(CLRS::maximumSubArray(lst.begin(), lst.end()), 3);
+    }
+    {
+        // parallel maximum subarray, compared with sequential one
+        std::mt19937 gen(3);
+        std::uniform_int_distribution<long long> dist(-1000, 990);
+        std::uniform_int_distribution<long long> smallDist(-2, 2); // many subarrays of the same sum
+        for (std::size_t n : {std::size_t(100), std::size_t(1000000), std::size_t(100000)})
+        {
+            std::vector<long long> vec(n);
+            std::generate(vec.begin(), vec.end(), [&]() { return n == 100000 ? smallDist(gen) : dist(gen); });
+            auto [begin, end, sum] = CLRS::maximumSubArrayRange(vec.begin(), vec.end());
+            util.assertEqual(std::accumulate(begin, end, 0LL), sum);
+            for (std::size_t threads : {2, 3, 7})
+            {
+                // the same range whatever the thread count is
+                auto [pbegin, pend, psum] = CLRS::parallelMaximumSubArrayRange(vec.begin(), vec.end(), threads);
+                util.assertEqual(psum, sum);
+                util.assertEqual(pbegin - vec.begin(), begin - vec.begin());
+                util.assertEqual(pend - vec.begin(), end - vec.begin());
+            }
+        }
+        {
+            // ties across the chunk boundary: [16383, 16386) and [16385, 16386) have the same sum
+            std::vector<long long> vec(32768, -100);
+            std::vector<long long> middle{1, -1, 3, -10, 2};
+            std::copy(middle.begin(), middle.end(), vec.begin() + 16383);
+            auto [pbegin, pend, psum] = CLRS::parallelMaximumSubArrayRange(vec.begin(), vec.end(), 2);
+            util.assertEqual(pbegin - vec.begin(), 16385);
+            util.assertEqual(pend - vec.begin(), 16386);
+            util.assertEqual(psum, 3LL);
+        }
+        // best subarray across chunks
+        std::vector<long long> vec(1 << 18, -1);
+        std::fill(vec.begin() + 1000, vec.begin() + 200000, 1);
+        auto [pbegin, pend, psum] = CLRS::parallelMaximumSubArrayRange(vec.begin(), vec.end(), 8);
+        util.assertEqual(pbegin - vec.begin(), 1000);
+        util.assertEqual(pend - vec.begin(), 200000);
+        util.assertEqual(psum, 199000LL);
     }
     {
         // minimum calculation times of matrix chain order
@@ -20,6 +80,69 @@ void testDP(DetailFlag detail)
         auto res = CLRS::minimumMatrixChainOrder(vec.begin(), vec.end());
         util.assertEqual(CLRS::optimalMatrixChainOrderAsString(res.second, 0, 5), "((A0(A1A2))((A3A4)A5))");
         util.assertEqual(res.first[0][5], 15125);
+        auto res2 = CLRS::parallelMinimumMatrixChainOrder(vec.begin(), vec.end());
+        util.assertEqual(CLRS::optimalMatrixChainOrderAsString(res2.second, 0, 5), "((A0(A1A2))((A3A4)A5))");
+        util.assertEqual(res2.first[0][5], 15125);
+    }
+    {
+        // flat table and wavefront parallel version, same costs and splits as the textbook one
+        std::mt19937 gen(5);
+        std::uniform_int_distribution<long long> dist(1, 100);
+        bool same = true;
+        for (std::size_t n : {1, 2, 3, 10, 57, 300, 600})
+        {
+            std::vector<long long> dims(n + 1);
+            std::generate(dims.begin(), dims.end(), [&]() { return dist(gen); });
+            auto [m, s] = CLRS::minimumMatrixChainOrder(dims.begin(), dims.end());
+            auto [m2, s2] = CLRS::parallelMinimumMatrixChainOrder(dims.begin(), dims.end(), 4);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t j = i; j < n; ++j)
+                    same = same && m[i][j] == m2[i][j] && s[i][j] == s2[i][j];
+            }
+        }
+        util.assertEqual(same, true);
+    }
+    {
+        // Hu-Shing polygon partitioning, same minimum costs as the cubic one, the splits give an order of that cost
+        std::vector<int> vec{30, 35, 15, 5, 10, 20, 25};
+        auto [cost, s] = CLRS::huShingMatrixChainOrder(vec.begin(), vec.end());
+        util.assertEqual(cost, 15125LL);
+        util.assertEqual(CLRS::optimalMatrixChainOrderAsString(s, 0, 5), "((A0(A1A2))((A3A4)A5))");
+        std::mt19937 gen(7);
+        bool same = true;
+        for (int round = 0; round < 2000; ++round)
+        {
+            std::uniform_int_distribution<long long> dist(1, round % 2 ? 4 : 1000); // few values for ties
+            std::vector<long long> dims(2 + round % 40);
+            std::generate(dims.begin(), dims.end(), [&]() { return dist(gen); });
+            std::size_t n = dims.size() - 1;
+            auto [m, s1] = CLRS::minimumMatrixChainOrder(dims.begin(), dims.end());
+            auto [cost2, s2] = CLRS::huShingMatrixChainOrder(dims.begin(), dims.end());
+            // cost of the order of s2, chains are visited from the outside in and summed up
+            long long orderCost = 0;
+            std::vector<std::pair<std::size_t, std::size_t>> chains{{0, n - 1}};
+            while (!chains.empty())
+            {
+                auto [i, j] = chains.back();
+                chains.pop_back();
+                if (i == j)
+                    continue;
+                std::size_t k = s2[i][j];
+                orderCost += dims[i] * dims[k+1] * dims[j+1];
+                chains.emplace_back(i, k);
+                chains.emplace_back(k + 1, j);
+            }
+            same = same && m[0][n-1] == cost2 && orderCost == cost2;
+        }
+        util.assertEqual(same, true);
+        // huge chain, the order is as deep as the chain
+        std::vector<long long> dims(100001);
+        std::iota(dims.begin(), dims.end(), 1);
+        auto [cost3, s3] = CLRS::huShingMatrixChainOrder(dims.begin(), dims.end());
+        util.assertEqual(cost3, 333343333399998LL); // (((A0A1)A2)...) costs sum of k*(k+1) over k = 2..100000
+        auto order = CLRS::optimalMatrixChainOrderAsString(s3, 0, 99999);
+        util.assertEqual(order.substr(99999 - 3, 10), "(((A0A1)A2");
     }
     {
         // longest common subsequence (LCS) problem
@@ -32,5 +155,196 @@ void testDP(DetailFlag detail)
         CLRS::LCSResultToSubsequence(sa.begin(), sa.end(), res.second, std::back_inserter(slcs), sa.size(), sb.size());
         util.assertEqual(slcs == "BCBA" || slcs == "BCAB" || slcs == "BDAB", true);
     }
+    {
+        // tiled wavefront parallel LCS, same tables as LCS for any tile size and thread count
+        std::mt19937 gen(17);
+        bool same = true;
+        for (int round = 0; round < 40; ++round)
+        {
+            std::uniform_int_distribution<int> letter('a', round % 2 ? 'c' : 'z');
+            std::string x(gen() % 300, ' '), y(gen() % 300, ' ');
+            for (auto* str : {&x, &y})
+                std::generate(str->begin(), str->end(), [&]() { return static_cast<char>(letter(gen)); });
+            auto expected = CLRS::LCS(x.begin(), x.end(), y.begin(), y.end());
+            for (std::size_t tileSize : {1, 7, 64, 256})
+            {
+                auto res = CLRS::parallelLCS(x.begin(), x.end(), y.begin(), y.end(), 1 + round % 4, tileSize);
+                same = same && res == expected;
+            }
+        }
+        util.assertEqual(same, true);
+        std::string sa = "ABCBDAB";
+        std::string sb = "BDCABA";
+        auto res = CLRS::parallelLCS(sa.begin(), sa.end(), sb.begin(), sb.end(), 2, 2);
+        std::string slcs;
+        CLRS::LCSResultToSubsequence(sa.begin(), sa.end(), res.second, std::back_inserter(slcs), sa.size(), sb.size());
+        util.assertEqual(slcs == "BCBA" || slcs == "BCAB" || slcs == "BDAB", true);
+    }
+    {
+        // linear space LCS (Hirschberg) and LCS length by rolling rows, same lengths as LCS, results are common subsequences
+        std::string sa = "ABCBDAB";
+        std::string sb = "BDCABA";
+        std::string slcs;
+        util.assertEqual(CLRS::hirschbergLCS(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(slcs)), std::size_t(4));
+        util.assertEqual(slcs == "BCBA" || slcs == "BCAB" || slcs == "BDAB", true);
+        util.assertEqual(CLRS::LCSLength(sa.begin(), sa.end(), sb.begin(), sb.end()), std::size_t(4));
+        auto isSubsequence = [](const auto& sub, const auto& seq) {
+            std::size_t pos = 0;
+            for (const auto& elem : seq)
+                pos += pos < sub.size() && sub[pos] == elem;
+            return pos == sub.size();
+        };
+        std::mt19937 gen(11);
+        bool same = true;
+        for (int round = 0; round < 300; ++round)
+        {
+            std::uniform_int_distribution<int> letter('a', round % 3 ? 'd' : 'z');
+            std::string x(gen() % 60, ' '), y(gen() % 60, ' ');
+            for (auto* str : {&x, &y})
+                std::generate(str->begin(), str->end(), [&]() { return static_cast<char>(letter(gen)); });
+            auto [c, b] = CLRS::LCS(x.begin(), x.end(), y.begin(), y.end());
+            std::string sub;
+            std::size_t len = CLRS::hirschbergLCS(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(sub));
+            same = same && len == c[x.size()][y.size()] && sub.size() == len && isSubsequence(sub, x) && isSubsequence(sub, y)
+                && CLRS::LCSLength(x.begin(), x.end(), y.begin(), y.end()) == len;
+        }
+        util.assertEqual(same, true);
+        // longer sequences, the first one is the shorter one
+        std::vector<int> x(8000), y(5000);
+        std::uniform_int_distribution<int> value(0, 3);
+        std::generate(x.begin(), x.end(), [&]() { return value(gen); });
+        std::generate(y.begin(), y.end(), [&]() { return value(gen); });
+        std::vector<int> sub;
+        std::size_t len = CLRS::hirschbergLCS(y.begin(), y.end(), x.begin(), x.end(), std::back_inserter(sub));
+        util.assertEqual(len, CLRS::LCSLength(x.begin(), x.end(), y.begin(), y.end()));
+        util.assertEqual(sub.size() == len && isSubsequence(sub, x) && isSubsequence(sub, y), true);
+    }
+    {
+        // bit-parallel LCS length, one and more words, single pair and batch, same lengths as LCSLength
+        std::string sa = "ABCBDAB";
+        std::string sb = "BDCABA";
+        util.assertEqual(CLRS::bitParallelLCSLength(sa.begin(), sa.end(), sb.begin(), sb.end()), std::size_t(4));
+        std::mt19937 gen(13);
+        std::vector<std::string> candidates;
+        for (std::size_t len : {0, 1, 5, 63, 64, 65, 127, 128, 129, 300, 1000})
+        {
+            for (char maxLetter : {'b', 'z'})
+            {
+                std::uniform_int_distribution<int> letter('a', maxLetter);
+                std::string str(len, ' ');
+                std::generate(str.begin(), str.end(), [&]() { return static_cast<char>(letter(gen)); });
+                candidates.push_back(std::move(str));
+            }
+        }
+        bool same = true;
+        for (const auto& query : candidates)
+        {
+            std::vector<std::size_t> lengths;
+            CLRS::bitParallelLCSLengths(query.begin(), query.end(), candidates.begin(), candidates.end(), std::back_inserter(lengths));
+            same = same && lengths.size() == candidates.size();
+            for (std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                const auto& text = candidates[i];
+                std::size_t len = CLRS::LCSLength(query.begin(), query.end(), text.begin(), text.end());
+                same = same && lengths[i] == len && CLRS::bitParallelLCSLength(query.begin(), query.end(), text.begin(), text.end()) == len;
+            }
+        }
+        util.assertEqual(same, true);
+        // bytes with the high bit set
+        std::vector<unsigned char> x{0, 255, 128, 7, 255}, y{255, 7, 128, 255, 0};
+        util.assertEqual(CLRS::bitParallelLCSLength(x.begin(), x.end(), y.begin(), y.end()), CLRS::LCSLength(x.begin(), x.end(), y.begin(), y.end()));
+    }
+    {
+        // Myers diff, edit scripts turn x into y with xlen + ylen - 2*LCS edits, cost cap
+        std::string x = "ABCABBA", y = "CBABAC";
+        std::vector<CLRS::EditHunk> hunks;
+        util.assertEqual(CLRS::myersDiff(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(hunks)).value_or(0), std::size_t(5));
+        std::vector<CLRS::EditHunk> capped;
+        util.assertEqual(CLRS::myersDiff(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(capped), 4).has_value(), false);
+        util.assertEqual(capped.empty(), true);
+        auto apply = [](const std::string& from, const std::string& to, const std::vector<CLRS::EditHunk>& script) {
+            std::string res;
+            std::size_t xpos = 0, ypos = 0;
+            bool valid = true;
+            for (const auto& hunk : script)
+            {
+                valid = valid && hunk.xpos == xpos && hunk.ypos == ypos && hunk.length > 0;
+                if (hunk.operation == CLRS::EditOperation::keep)
+                {
+                    valid = valid && from.compare(xpos, hunk.length, to, ypos, hunk.length) == 0;
+                    res += from.substr(xpos, hunk.length);
+                }
+                else if (hunk.operation == CLRS::EditOperation::insert)
+                    res += to.substr(ypos, hunk.length);
+                xpos += hunk.operation != CLRS::EditOperation::insert ? hunk.length : 0;
+                ypos += hunk.operation != CLRS::EditOperation::erase ? hunk.length : 0;
+            }
+            return valid && xpos == from.size() && res == to;
+        };
+        util.assertEqual(apply(x, y, hunks), true);
+        std::mt19937 gen(19);
+        bool same = true;
+        for (int round = 0; round < 500; ++round)
+        {
+            std::uniform_int_distribution<int> letter('a', round % 2 ? 'c' : 'z');
+            std::string a(gen() % 50, ' '), b(gen() % 50, ' ');
+            for (auto* str : {&a, &b})
+                std::generate(str->begin(), str->end(), [&]() { return static_cast<char>(letter(gen)); });
+            std::vector<CLRS::EditHunk> script;
+            auto cost = CLRS::myersDiff(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(script));
+            same = same && cost == a.size() + b.size() - 2 * CLRS::LCSLength(a.begin(), a.end(), b.begin(), b.end()) && apply(a, b, script);
+        }
+        util.assertEqual(same, true);
+        // near-identical long inputs
+        std::string a(1000000, ' ');
+        std::uniform_int_distribution<int> letter('a', 'z');
+        std::generate(a.begin(), a.end(), [&]() { return static_cast<char>(letter(gen)); });
+        std::string b = a;
+        b.insert(b.begin() + 1000, 'X');
+        b.erase(b.begin() + 500000, b.begin() + 500003);
+        b[900000] = 'Y';
+        std::vector<CLRS::EditHunk> script;
+        util.assertEqual(CLRS::myersDiff(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(script)).value_or(0), std::size_t(6));
+        util.assertEqual(apply(a, b, script), true);
+    }
+    {
+        // optimal binary search tree, the example of CLRS and the cubic recurrence on random frequencies
+        std::vector<double> p{0.15, 0.10, 0.05, 0.10, 0.20};
+        std::vector<double> q{0.05, 0.10, 0.05, 0.05, 0.05, 0.10};
+        auto [e, root] = CLRS::optimalBST(p.begin(), p.end(), q.begin(), q.end());
+        util.assertEqual(std::abs(e[0][5] - 2.75) < 1e-9, true);
+        util.assertEqual(root[0][5], std::size_t(1));
+        std::vector<int> keys{10, 20, 30, 40, 50};
+        auto tree = CLRS::optimalBSTToTree<CLRS::BsTree<int, int, std::identity>>(keys.begin(), keys.end(), root);
+        util.assertEqual(tree.size(), std::size_t(5));
+        util.assertEqual(std::equal(tree.begin(), tree.end(), keys.begin(), keys.end()), true);
+        std::mt19937 gen(23);
+        std::uniform_int_distribution<long long> freq(0, 100);
+        bool same = true;
+        for (std::size_t n : {0, 1, 2, 5, 17, 60})
+        {
+            std::vector<long long> fp(n), fq(n + 1);
+            std::generate(fp.begin(), fp.end(), [&]() { return freq(gen); });
+            std::generate(fq.begin(), fq.end(), [&]() { return freq(gen); });
+            auto [cost, r] = CLRS::optimalBST(fp.begin(), fp.end(), fq.begin(), fq.end());
+            // e2[i][j] of the cubic recurrence
+            std::vector<std::vector<long long>> e2(n + 1, std::vector<long long>(n + 1));
+            for (std::size_t i = 0; i <= n; ++i)
+                e2[i][i] = fq[i];
+            for (std::size_t len = 1; len <= n; ++len)
+            {
+                for (std::size_t i = 0; i + len <= n; ++i)
+                {
+                    std::size_t j = i + len;
+                    long long w = std::accumulate(fp.begin() + i, fp.begin() + j, 0LL) + std::accumulate(fq.begin() + i, fq.begin() + j + 1, 0LL);
+                    e2[i][j] = std::numeric_limits<long long>::max();
+                    for (std::size_t k = i; k < j; ++k)
+                        e2[i][j] = std::min(e2[i][j], e2[i][k] + e2[k+1][j] + w);
+                }
+            }
+            same = same && cost[0][n] == e2[0][n];
+        }
+        util.assertEqual(same, true);
+    }
     util.showFinalResult();
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "TestUtil.hpp"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <functional>
+#include <concepts>
+#include <Instrumentation.hpp>
+#include <Sorting.hpp>
+#include <DP.hpp>
+#include <Tree.hpp>
+
+void testInstrumentation(DetailFlag detail)
+{
+    TestUtil util(detail, "instrumentation");
+    std::vector<int> vec(1000, 0);
+    std::iota(vec.begin(), vec.end(), 0);
+    std::shuffle(vec.begin(), vec.end(), std::mt19937());
+    // disabled instrumentation compiles away to the wrapped types
+    static_assert(!CLRS::instrumentationEnabled);
+    static_assert(std::same_as<CLRS::Instrumented<int>, int>);
+    static_assert(std::same_as<CLRS::CountingCompare<std::greater<>>, std::greater<>>);
+    static_assert(std::same_as<CLRS::CountingAllocator<int>, std::allocator<int>>);
+    {
+        // counting comparator
+        std::vector<int> tmp(vec);
+        std::size_t comparisons = 0;
+        CLRS::quickSort(tmp.begin(), tmp.end(), [&comparisons](int a, int b) { ++comparisons; return a < b; });
+        tmp = vec;
+        auto before = CLRS::instrumentationStats();
+        CLRS::quickSort(tmp.begin(), tmp.end(), CLRS::BasicCountingCompare<>());
+        auto stats = CLRS::instrumentationStats() - before;
+        util.assertSorted(tmp.begin(), tmp.end());
+        util.assertEqual(stats.comparisons, comparisons);
+        util.assertEqual(stats.moves, std::uint64_t(0));
+    }
+    {
+        // instrumented values: copies and moves
+        std::vector<CLRS::BasicInstrumented<int>> tmp(vec.begin(), vec.end());
+        CLRS::resetInstrumentationStats();
+        CLRS::mergeSort(tmp.begin(), tmp.end());
+        auto stats = CLRS::instrumentationStats();
+        util.assertSorted(tmp.begin(), tmp.end());
+        util.assertEqual(stats.comparisons > 0 && stats.comparisons < 1000 * 20, true);
+        util.assertEqual(stats.moves >= 1000, true);
+        util.assertEqual(stats.copies, std::uint64_t(0));
+        auto copied = tmp;
+        util.assertEqual((CLRS::instrumentationStats() - stats).copies, std::uint64_t(1000));
+        std::vector<CLRS::BasicInstrumented<std::string>> strs;
+        for (int val : vec)
+            strs.emplace_back(std::to_string(val));
+        CLRS::msdRadixSort(strs.begin(), strs.end());
+        util.assertEqual(std::is_sorted(strs.begin(), strs.end()), true);
+    }
+    {
+        // allocations of containers, global allocations are counted by standalone/TestReplaceNew.cpp
+        CLRS::resetInstrumentationStats();
+        {
+            std::vector<int, CLRS::BasicCountingAllocator<int>> tmp;
+            tmp.reserve(1000);
+            for (int i = 0; i < 1000; ++i)
+                tmp.push_back(i);
+            auto stats = CLRS::instrumentationStats();
+            util.assertEqual(stats.allocations, std::uint64_t(1));
+            util.assertEqual(stats.allocatedBytes >= 1000 * sizeof(int), true);
+        }
+        util.assertEqual(CLRS::instrumentationStats().deallocations, std::uint64_t(1));
+    }
+    {
+        // DP
+        std::vector<CLRS::BasicInstrumented<int>> arr{12, -3, -25, 20, -3, -16, -23, 18, 20, -7, 12, -5, -22, 15, -4, 7};
+        CLRS::resetInstrumentationStats();
+        util.assertEqual(CLRS::maximumSubArray(arr.begin(), arr.end()).value, 43);
+        util.assertEqual(CLRS::instrumentationStats().comparisons > 0, true);
+        std::string x = "ABCBDAB", y = "BDCABA";
+        std::vector<CLRS::BasicInstrumented<char>> ix(x.begin(), x.end()), iy(y.begin(), y.end());
+        CLRS::resetInstrumentationStats();
+        auto [c, b] = CLRS::LCS(ix.begin(), ix.end(), iy.begin(), iy.end());
+        util.assertEqual(c[x.size()][y.size()], std::size_t(4));
+        util.assertEqual(CLRS::instrumentationStats().comparisons, std::uint64_t(x.size() * y.size()));
+    }
+    {
+        // trees
+        CLRS::BsTree<int, int, std::identity, false, CLRS::BasicCountingCompare<std::less<int>>> tree;
+        CLRS::resetInstrumentationStats();
+        for (int val : vec)
+            tree.insert(val);
+        auto stats = CLRS::instrumentationStats();
+        util.assertEqual(tree.size(), std::size_t(1000));
+        util.assertEqual(stats.comparisons > 1000, true);
+        CLRS::RbTree<CLRS::BasicInstrumented<int>, CLRS::BasicInstrumented<int>, std::identity> rbTree;
+        for (int val : vec)
+            rbTree.insert(val);
+        util.assertEqual(rbTree.size(), std::size_t(1000));
+        util.assertEqual(CLRS::instrumentationStats().comparisons - stats.comparisons < 1000 * 2 * 20, true);
+    }
+    util.showFinalResult();
+}
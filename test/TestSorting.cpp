@@ -4,6 +4,17 @@
 #include <numeric>
 #include <random>
 #include <string>
+#include <string_view>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <ranges>
+#include <functional>
+#include <array>
+#include <utility>
 #include <Sorting.hpp>
 
 void testSorting(DetailFlag detail)
@@ -45,6 +56,66 @@ void testSorting(DetailFlag detail)
             util.assertSequenceEqual(tmp, tmp2);
         }
     }
+    {
+        // small sort by sorting network, all sizes and padding
+        auto testSmallSort = []<typename T, std::size_t N>(std::array<T, N> arr) {
+            std::mt19937 rng(static_cast<unsigned>(N));
+            bool sorted = true;
+            for (int round = 0; round < 20; ++round)
+            {
+                for (auto& val : arr)
+                    val = static_cast<T>(static_cast<int>(rng() % 21) - 10);
+                if (round == 0 && N > 0)
+                    arr[0] = std::numeric_limits<T>::max();
+                auto expected = arr;
+                std::sort(expected.begin(), expected.end());
+                CLRS::smallSort(arr);
+                sorted = sorted && arr == expected;
+            }
+            return sorted;
+        };
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            util.assertEqual((testSmallSort(std::array<int, I + 1>{}) && ...), true);
+            util.assertEqual((testSmallSort(std::array<float, I + 1>{}) && ...), true);
+            util.assertEqual((testSmallSort(std::array<double, I + 1>{}) && ...), true);
+            util.assertEqual((testSmallSort(std::array<std::int64_t, I + 1>{}) && ...), true);
+            util.assertEqual((testSmallSort(std::array<std::uint8_t, I + 1>{}) && ...), true);
+        }(std::make_index_sequence<32>());
+        {
+            int arr[5] = {3, -1, 4, 1, -5};
+            CLRS::smallSort(arr);
+            util.assertSorted(std::begin(arr), std::end(arr));
+        }
+        // sorting network as base case of quick sort and merge sort
+        {
+            std::mt19937 rng(12);
+            for (std::size_t n : {0, 1, 7, 31, 32, 33, 100, 1000})
+            {
+                std::vector<int> ints(n);
+                std::vector<double> doubles(n);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    ints[i] = static_cast<int>(rng() % 50);
+                    doubles[i] = static_cast<double>(ints[i]) / 4.0;
+                }
+                auto ints2 = ints, ints3 = ints, expected = ints;
+                std::sort(expected.begin(), expected.end());
+                CLRS::quickSort(ints2.begin(), ints2.end());
+                CLRS::mergeSort(ints3.begin(), ints3.end(), std::less<int>());
+                util.assertSequenceEqual(ints2, expected);
+                util.assertSequenceEqual(ints3, expected);
+                std::reverse(expected.begin(), expected.end());
+                CLRS::quickSort(ints.begin(), ints.end(), std::greater<>());
+                util.assertSequenceEqual(ints, expected);
+                auto doubles2 = doubles, expectedDoubles = doubles;
+                std::sort(expectedDoubles.begin(), expectedDoubles.end(), std::greater<>());
+                CLRS::quickSort(doubles.begin(), doubles.end(), std::greater<double>());
+                CLRS::mergeSort(doubles2.begin(), doubles2.end(), std::greater<>());
+                util.assertSequenceEqual(doubles, expectedDoubles);
+                util.assertSequenceEqual(doubles2, expectedDoubles);
+            }
+        }
+    }
     {
         // merge sort
         {
@@ -78,6 +149,170 @@ void testSorting(DetailFlag detail)
             util.assertSequenceEqual(tmp, tmp2);
         }
     }
+    {
+        // parallel merge sort
+        {
+            std::vector<int> tmp(vec);
+            CLRS::parallelMergeSort(tmp.begin(), tmp.end());
+            util.assertSorted(tmp.begin(), tmp.end());
+        }
+        {
+            std::vector<int> tmp(100000);
+            std::mt19937 gen;
+            std::uniform_int_distribution<int> dist(0, 999);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen); });
+            std::vector<int> tmp2(tmp);
+            CLRS::parallelMergeSort(tmp.begin(), tmp.end(), std::greater<>(), 4);
+            util.assertSorted(tmp.begin(), tmp.end(), std::greater<>());
+            std::sort(tmp2.begin(), tmp2.end(), std::greater<>());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // stability: sort (key, original index) pairs by key only
+            std::vector<std::pair<int, int>> tmp(100000);
+            std::mt19937 gen;
+            std::uniform_int_distribution<int> dist(0, 99);
+            for (int i = 0; i < (int)tmp.size(); ++i)
+            {
+                tmp[i] = {dist(gen), i};
+            }
+            std::vector<std::pair<int, int>> tmp2(tmp);
+            CLRS::parallelMergeSort(tmp.begin(), tmp.end(), [](const auto& a, const auto& b) { return a.first < b.first; }, 3);
+            std::stable_sort(tmp2.begin(), tmp2.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            std::vector<std::string> tmp;
+            std::transform(vec.begin(), vec.end(), std::back_inserter(tmp), [](int val) -> std::string { return std::to_string(val); });
+            std::vector<std::string> tmp2(tmp);
+            CLRS::parallelMergeSort(tmp.begin(), tmp.end(), std::less<>(), 2);
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+    }
+    {
+        // multiway merge
+        std::mt19937 gen;
+        std::vector<std::vector<std::pair<int, int>>> inputs(37);
+        std::vector<std::pair<int, int>> expected;
+        for (int i = 0; i < (int)inputs.size(); ++i)
+        {
+            inputs[i].resize(i % 5 == 0 ? 0 : gen() % 3000);
+            for (auto& elem : inputs[i])
+            {
+                elem = {gen() % 500, i};
+            }
+            std::sort(inputs[i].begin(), inputs[i].end());
+            std::copy(inputs[i].begin(), inputs[i].end(), std::back_inserter(expected));
+        }
+        auto byFirst = [](const auto& a, const auto& b) { return a.first < b.first; };
+        std::stable_sort(expected.begin(), expected.end(), byFirst); // stable: ties in order of input index
+        {
+            std::vector<std::pair<int, int>> result;
+            CLRS::multiwayMerge(inputs, std::back_inserter(result), byFirst);
+            util.assertSequenceEqual(result, expected);
+        }
+        {
+            std::vector<std::pair<int, int>> result(expected.size());
+            auto end = CLRS::parallelMultiwayMerge(inputs, result.begin(), byFirst, 4);
+            util.assertEqual(end == result.end(), true);
+            util.assertSequenceEqual(result, expected);
+        }
+        {
+            // 150 runs of very uneven lengths with many ties, the second member numbers elements to check stability
+            std::vector<std::vector<std::pair<int, int>>> runs(150);
+            std::vector<std::pair<int, int>> expected2;
+            int id = 0;
+            for (std::size_t i = 0; i < runs.size(); ++i)
+            {
+                runs[i].resize(i % 7 == 0 ? gen() % 3 : (i % 11 == 0 ? 20000 + gen() % 5000 : gen() % 200));
+                for (auto& elem : runs[i])
+                {
+                    elem.first = gen() % 100;
+                }
+                std::sort(runs[i].begin(), runs[i].end());
+                for (auto& elem : runs[i])
+                {
+                    elem.second = id++;
+                }
+                std::copy(runs[i].begin(), runs[i].end(), std::back_inserter(expected2));
+            }
+            std::stable_sort(expected2.begin(), expected2.end(), byFirst);
+            for (std::size_t threads : {2, 7, 64})
+            {
+                std::vector<std::pair<int, int>> result(expected2.size());
+                CLRS::parallelMultiwayMerge(runs, result.begin(), byFirst, threads);
+                util.assertSequenceEqual(result, expected2);
+            }
+        }
+        {
+            // input streams
+            std::istringstream is1("1 4 7 10"), is2("2 5 8"), is3("3 6 9 11 12");
+            std::vector<std::ranges::subrange<std::istream_iterator<int>>> streams{
+                {std::istream_iterator<int>(is1), std::istream_iterator<int>()},
+                {std::istream_iterator<int>(is2), std::istream_iterator<int>()},
+                {std::istream_iterator<int>(is3), std::istream_iterator<int>()}};
+            std::vector<int> result;
+            CLRS::multiwayMerge(streams, std::back_inserter(result));
+            std::vector<int> expected2(12);
+            std::iota(expected2.begin(), expected2.end(), 1);
+            util.assertSequenceEqual(result, expected2);
+        }
+    }
+    {
+        // tim sort
+        std::mt19937 gen;
+        {
+            std::vector<int> tmp(vec);
+            CLRS::timSort(tmp.begin(), tmp.end());
+            util.assertSorted(tmp.begin(), tmp.end());
+        }
+        {
+            std::vector<std::string> tmp;
+            std::transform(vec.begin(), vec.end(), std::back_inserter(tmp), [](int val) -> std::string { return std::to_string(val); });
+            std::vector<std::string> tmp2(tmp);
+            CLRS::timSort(tmp.begin(), tmp.end(), std::greater<>());
+            std::sort(tmp2.begin(), tmp2.end(), std::greater<>());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // stability on partially sorted input: sorted blocks, reversed blocks and random swaps
+            std::vector<std::pair<int, int>> tmp(100000);
+            std::uniform_int_distribution<int> dist(0, 999);
+            for (auto& elem : tmp)
+            {
+                elem.first = dist(gen);
+            }
+            for (std::size_t i = 0; i < tmp.size(); i += 5000)
+            {
+                std::sort(tmp.begin() + i, tmp.begin() + i + 2500);
+                std::sort(tmp.begin() + i + 2500, tmp.begin() + i + 5000, std::greater<>());
+            }
+            for (int i = 0; i < (int)tmp.size(); ++i)
+            {
+                tmp[i].second = i;
+            }
+            auto byFirst = [](const auto& a, const auto& b) { return a.first < b.first; };
+            std::vector<std::pair<int, int>> tmp2(tmp);
+            CLRS::timSort(tmp.begin(), tmp.end(), byFirst);
+            std::stable_sort(tmp2.begin(), tmp2.end(), byFirst);
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // sorted and reverse sorted input: N-1 comparisons to find the only run
+            std::vector<int> tmp(100000);
+            std::iota(tmp.begin(), tmp.end(), 0);
+            std::size_t comparisons = 0;
+            auto counting = [&comparisons](int a, int b) { ++comparisons; return a < b; };
+            CLRS::timSort(tmp.begin(), tmp.end(), counting);
+            util.assertEqual(comparisons, tmp.size() - 1);
+            std::reverse(tmp.begin(), tmp.end());
+            comparisons = 0;
+            CLRS::timSort(tmp.begin(), tmp.end(), counting);
+            util.assertSorted(tmp.begin(), tmp.end());
+            util.assertEqual(comparisons, tmp.size() - 1);
+        }
+    }
     {
         // heap sort
         {
@@ -110,6 +345,43 @@ void testSorting(DetailFlag detail)
             std::sort(tmp2.begin(), tmp2.end(), std::less<>());
             util.assertSequenceEqual(tmp, tmp2);
         }
+        // binary and 8-ary heaps, all sizes of the last incomplete node
+        for (std::size_t n : {0, 1, 2, 7, 8, 9, 10, 65, 1000})
+        {
+            std::vector<int> tmp(vec.begin(), vec.begin() + n), tmp2(tmp), expected(tmp);
+            std::sort(expected.begin(), expected.end());
+            CLRS::makeHeap<2>(tmp.begin(), tmp.end());
+            CLRS::makeHeap<8>(tmp2.begin(), tmp2.end());
+            util.assertEqual(CLRS::isHeap<2>(tmp.begin(), tmp.end()), true);
+            util.assertEqual(CLRS::isHeap<8>(tmp2.begin(), tmp2.end()), true);
+            CLRS::sortHeap<2>(tmp.begin(), tmp.end());
+            CLRS::sortHeap<8>(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, expected);
+            util.assertSequenceEqual(tmp2, expected);
+        }
+        // priority queue
+        {
+            CLRS::PriorityQueue<int> pq(vec.begin(), vec.begin() + 500);
+            for (auto iter = vec.begin() + 500; iter != vec.end(); ++iter)
+                pq.push(*iter);
+            util.assertEqual(pq.size(), vec.size());
+            util.assertEqual(CLRS::isHeap(pq.data().begin(), pq.data().end()), true);
+            pq.replaceTop(-1);
+            util.assertEqual(pq.top(), 998);
+            std::vector<int> popped;
+            while (!pq.empty())
+                popped.push_back(pq.extractTop());
+            util.assertSorted(popped.begin(), popped.end(), std::greater<>());
+            util.assertEqual(popped.back(), -1);
+
+            CLRS::PriorityQueue<std::string, 8, std::greater<>> minQueue;
+            for (const char* str : {"d", "b", "e", "a", "c"})
+                minQueue.emplace(str);
+            std::string res;
+            for (; !minQueue.empty(); minQueue.pop())
+                res += minQueue.top();
+            util.assertEqual(res, std::string("abcde"));
+        }
     }
     {
         // quick sort
@@ -144,6 +416,206 @@ void testSorting(DetailFlag detail)
             util.assertSequenceEqual(tmp, tmp2);
         }
     }
+    {
+        // partition
+        for (std::size_t size : {0, 1, 100, 129, 1000, 100000})
+        {
+            std::vector<int> tmp(size);
+            std::mt19937 gen;
+            std::uniform_int_distribution<int> dist(0, 99);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen); });
+            std::vector<int> tmp2(tmp);
+            auto pred = [](int elem) { return elem < 30; };
+            auto middle = CLRS::partition(tmp.begin(), tmp.end(), pred);
+            util.assertEqual(std::is_partitioned(tmp.begin(), tmp.end(), pred), true);
+            util.assertEqual(middle - tmp.begin(), std::count_if(tmp2.begin(), tmp2.end(), pred));
+            util.assertSetEqual(tmp, tmp2);
+        }
+    }
+    {
+        // quick sort on patterned inputs: sorted, reversed, organ pipe, all equal, few unique, sawtooth
+        std::vector<std::vector<int>> inputs(6, std::vector<int>(100000));
+        std::iota(inputs[0].begin(), inputs[0].end(), 0);
+        std::iota(inputs[1].rbegin(), inputs[1].rend(), 0);
+        for (int i = 0; i < 100000; ++i)
+        {
+            inputs[2][i] = std::min(i, 100000 - i);
+            inputs[3][i] = 42;
+            inputs[4][i] = (i * 7919) % 5;
+            inputs[5][i] = i % 1000;
+        }
+        for (auto& input : inputs)
+        {
+            std::vector<int> tmp(input);
+            std::size_t comparisons = 0;
+            CLRS::quickSort(tmp.begin(), tmp.end(), [&comparisons](int a, int b) { ++comparisons; return a < b; });
+            std::sort(input.begin(), input.end());
+            util.assertSequenceEqual(tmp, input);
+            util.assertEqual(comparisons < 4 * 100000 * 17, true); // O(NlogN) comparisons
+        }
+    }
+    {
+        // selection
+        std::vector<int> sorted(vec);
+        std::sort(sorted.begin(), sorted.end());
+        {
+            bool allCorrect = true;
+            for (std::size_t i = 0; i < vec.size(); i += 37)
+            {
+                std::vector<int> tmp(vec);
+                auto nth = CLRS::select(tmp.begin(), tmp.end(), i);
+                allCorrect = allCorrect && *nth == sorted[i]
+                    && std::all_of(tmp.begin(), nth, [&](int val) { return val <= *nth; })
+                    && std::all_of(nth, tmp.end(), [&](int val) { return val >= *nth; });
+            }
+            util.assertEqual(allCorrect, true);
+        }
+        {
+            std::vector<int> tmp(vec);
+            CLRS::nthElement(tmp.begin(), tmp.begin() + 10, tmp.end(), std::greater<>());
+            util.assertEqual(tmp[10], sorted[sorted.size() - 11]);
+        }
+        {
+            // median of medians only
+            std::vector<int> tmp(vec);
+            auto comp = std::less<>();
+            CLRS::Impl::selectImpl(tmp.begin(), tmp.begin() + 500, tmp.end(), comp, 0, true);
+            util.assertEqual(tmp[500], 500);
+        }
+        // linear comparisons on patterns, duplicates and few unique values
+        std::vector<std::vector<int>> inputs(5, std::vector<int>(100000));
+        for (int i = 0; i < 100000; ++i)
+        {
+            inputs[0][i] = i;
+            inputs[1][i] = 100000 - i;
+            inputs[2][i] = std::min(i, 100000 - i);
+            inputs[3][i] = 42;
+            inputs[4][i] = (i * 7919) % 5;
+        }
+        for (auto& input : inputs)
+        {
+            std::vector<int> tmp(input);
+            std::size_t comparisons = 0;
+            CLRS::nthElement(tmp.begin(), tmp.begin() + 99000, tmp.end(), [&comparisons](int a, int b) { ++comparisons; return a < b; });
+            std::sort(input.begin(), input.end());
+            util.assertEqual(tmp[99000], input[99000]);
+            util.assertEqual(comparisons < 30 * 100000, true);
+        }
+    }
+    {
+        // top-k
+        std::vector<int> sorted(vec);
+        std::sort(sorted.begin(), sorted.end());
+        {
+            auto res = CLRS::topK(vec.begin(), vec.end(), 10);
+            util.assertRangeEqual(res.begin(), res.end(), sorted.begin(), sorted.begin() + 10);
+            res = CLRS::topK(vec.begin(), vec.end(), 10, std::greater<>());
+            util.assertRangeEqual(res.begin(), res.end(), sorted.rbegin(), sorted.rbegin() + 10);
+            util.assertEqual(CLRS::topK(vec.begin(), vec.end(), 0).size(), std::size_t(0));
+            util.assertSequenceEqual(CLRS::topK(vec.begin(), vec.end(), 2000), sorted);
+        }
+        {
+            // streaming over an input iterator
+            std::istringstream iss("5 3 9 1 7 3");
+            auto res = CLRS::topK(std::istream_iterator<int>(iss), std::istream_iterator<int>(), 3);
+            util.assertSequenceEqual(res, std::vector<int>{1, 3, 3});
+        }
+        {
+            std::vector<int> tmp(1000000);
+            std::mt19937 gen(7);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return static_cast<int>(gen() % 100000); });
+            auto res = CLRS::parallelTopK(tmp.begin(), tmp.end(), 100, std::greater<>(), 4);
+            std::sort(tmp.begin(), tmp.end(), std::greater<>());
+            util.assertRangeEqual(res.begin(), res.end(), tmp.begin(), tmp.begin() + 100);
+        }
+    }
+    {
+        // indirect sorting
+        struct Record
+        {
+            int key;
+            std::string name;
+            char payload[200];
+        };
+        std::vector<Record> records(2000);
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            records[i].key = vec[i % vec.size()] % 100;
+            records[i].name = std::to_string(i);
+        }
+        auto expected = records;
+        std::stable_sort(expected.begin(), expected.end(), [](const Record& a, const Record& b) { return a.key < b.key; });
+        auto sameOrder = [](const std::vector<Record>& a, const std::vector<Record>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Record& r1, const Record& r2) { return r1.name == r2.name; });
+        };
+        {
+            auto perm = CLRS::argSort(records.begin(), records.end(), std::less<>(), &Record::key);
+            bool permOrder = true;
+            for (std::size_t i = 0; i < perm.size(); ++i)
+                permOrder = permOrder && records[perm[i]].name == expected[i].name;
+            util.assertEqual(permOrder, true);
+            auto tmp = records;
+            auto perm2 = perm;
+            CLRS::applyPermutation(tmp.begin(), perm);
+            util.assertEqual(sameOrder(tmp, expected), true);
+            util.assertSequenceEqual(perm, perm2); // restored after applying
+        }
+        {
+            auto tmp = records;
+            CLRS::indirectSort(tmp.begin(), tmp.end(), std::less<>(), &Record::key);
+            util.assertEqual(sameOrder(tmp, expected), true);
+            // non-arithmetic keys are compared through the elements
+            CLRS::indirectSort(tmp.begin(), tmp.end(), std::greater<>(), &Record::name);
+            util.assertEqual(std::is_sorted(tmp.begin(), tmp.end(), [](const Record& a, const Record& b) { return a.name > b.name; }), true);
+        }
+        {
+            // structure of arrays
+            std::vector<double> keys(1000);
+            std::vector<int> ids(1000);
+            std::vector<std::string> names(1000);
+            for (std::size_t i = 0; i < 1000; ++i)
+            {
+                keys[i] = vec[i] / 10.0;
+                ids[i] = vec[i];
+                names[i] = std::to_string(vec[i]);
+            }
+            CLRS::coSort(keys.begin(), keys.end(), std::greater<>(), ids.begin(), names.begin());
+            util.assertSorted(keys.begin(), keys.end(), std::greater<>());
+            util.assertSorted(ids.begin(), ids.end(), std::greater<>());
+            bool matched = true;
+            for (std::size_t i = 0; i < 1000; ++i)
+                matched = matched && names[i] == std::to_string(ids[i]) && keys[i] == ids[i] / 10.0;
+            util.assertEqual(matched, true);
+        }
+    }
+    {
+        // parallel sample sort
+        std::mt19937 gen;
+        {
+            std::vector<int> tmp(vec);
+            CLRS::parallelSampleSort(tmp.begin(), tmp.end());
+            util.assertSorted(tmp.begin(), tmp.end());
+        }
+        for (int range : {1, 10, 1000, std::numeric_limits<int>::max()})
+        {
+            std::vector<int> tmp(200000);
+            std::uniform_int_distribution<int> dist(0, range - 1);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen); });
+            std::vector<int> tmp2(tmp);
+            CLRS::parallelSampleSort(tmp.begin(), tmp.end(), std::greater<>(), 4);
+            std::sort(tmp2.begin(), tmp2.end(), std::greater<>());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            std::vector<std::string> tmp(50000);
+            std::uniform_int_distribution<int> dist(0, 1000000);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return std::to_string(dist(gen)); });
+            std::vector<std::string> tmp2(tmp);
+            CLRS::parallelSampleSort(tmp.begin(), tmp.end(), std::less<>(), 3);
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+    }
     {
         // counting sort
         {
@@ -164,6 +636,281 @@ void testSorting(DetailFlag detail)
             util.assertSequenceEqual(tmp, tmp2);
         }
     }
+    {
+        // stable counting sort with key range and projection
+        {
+            std::vector<int> tmp(vec);
+            std::transform(tmp.begin(), tmp.end(), tmp.begin(), [](int val) { return val - 500; });
+            std::vector<int> tmp2(tmp);
+            CLRS::countingSort(tmp.begin(), tmp.end(), -500, 499);
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // records with payloads, keys in a small domain, sequential and parallel
+            std::vector<std::pair<short, std::string>> tmp;
+            std::mt19937 gen;
+            std::uniform_int_distribution<int> dist(-20, 20);
+            for (int i = 0; i < 50000; ++i)
+            {
+                tmp.emplace_back(static_cast<short>(dist(gen)), std::to_string(i));
+            }
+            std::vector<std::pair<short, std::string>> tmp2(tmp);
+            std::vector<std::pair<short, std::string>> tmp3(tmp);
+            CLRS::countingSort(tmp.begin(), tmp.end(), -20, 20, &std::pair<short, std::string>::first);
+            CLRS::countingSort(tmp2.begin(), tmp2.end(), -20, 20, [](const auto& p) { return p.first; }, 4);
+            std::stable_sort(tmp3.begin(), tmp3.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            util.assertSequenceEqual(tmp, tmp3);
+            util.assertSequenceEqual(tmp2, tmp3);
+        }
+    }
+    {
+        // radix sort
+        std::mt19937_64 gen;
+        {
+            std::vector<int> tmp(vec);
+            CLRS::radixSort(tmp.begin(), tmp.end());
+            util.assertSorted(tmp.begin(), tmp.end());
+        }
+        {
+            // signed keys with negative values, sequential and parallel
+            std::vector<long long> tmp(100000);
+            std::uniform_int_distribution<long long> dist(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max());
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen); });
+            std::vector<long long> tmp2(tmp);
+            std::vector<long long> tmp3(tmp);
+            CLRS::radixSort(tmp.begin(), tmp.end());
+            CLRS::radixSort(tmp2.begin(), tmp2.end(), std::identity(), 4);
+            std::sort(tmp3.begin(), tmp3.end());
+            util.assertSequenceEqual(tmp, tmp3);
+            util.assertSequenceEqual(tmp2, tmp3);
+        }
+        {
+            // floating-point keys
+            std::vector<double> tmp(100000);
+            std::uniform_real_distribution<double> dist(-1e6, 1e6);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen); });
+            tmp[0] = 0.0;
+            tmp[1] = std::numeric_limits<double>::infinity();
+            tmp[2] = -std::numeric_limits<double>::infinity();
+            tmp[3] = std::numeric_limits<double>::denorm_min();
+            std::vector<double> tmp2(tmp);
+            CLRS::radixSort(tmp.begin(), tmp.end());
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // records sorted by a projected key, stable
+            std::vector<std::pair<float, std::string>> tmp;
+            std::uniform_int_distribution<int> dist(-50, 50);
+            for (int i = 0; i < 10000; ++i)
+            {
+                tmp.emplace_back(dist(gen) * 0.5f, std::to_string(i));
+            }
+            std::vector<std::pair<float, std::string>> tmp2(tmp);
+            std::vector<std::pair<float, std::string>> tmp3(tmp);
+            CLRS::radixSort(tmp.begin(), tmp.end(), &std::pair<float, std::string>::first);
+            CLRS::radixSort(tmp2.begin(), tmp2.end(), [](const auto& p) { return p.first; }, 3);
+            std::stable_sort(tmp3.begin(), tmp3.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            util.assertSequenceEqual(tmp, tmp3);
+            util.assertSequenceEqual(tmp2, tmp3);
+        }
+        {
+            // -0.0 and +0.0 are equal keys, records of them keep the input order
+            std::vector<std::pair<double, int>> tmp{{0.0, 0}, {-0.0, 1}, {0.0, 2}, {-0.0, 3}, {-1.5, 4}, {0.0, 5}, {1.5, 6}, {-0.0, 7}};
+            std::vector<std::pair<double, int>> tmp2(tmp);
+            std::vector<std::pair<double, int>> tmp3(tmp);
+            CLRS::radixSort(tmp.begin(), tmp.end(), &std::pair<double, int>::first);
+            CLRS::radixSort(tmp2.begin(), tmp2.end(), &std::pair<double, int>::first, 2);
+            std::stable_sort(tmp3.begin(), tmp3.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            util.assertSequenceEqual(tmp, tmp3);
+            util.assertSequenceEqual(tmp2, tmp3);
+        }
+    }
+    {
+        // bucket sort
+        std::mt19937_64 gen;
+        {
+            std::vector<int> tmp(vec);
+            CLRS::bucketSort(tmp.begin(), tmp.end());
+            util.assertSorted(tmp.begin(), tmp.end());
+        }
+        {
+            // uniform doubles in [0, 1), sequential and parallel
+            std::vector<double> tmp(100000);
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen); });
+            std::vector<double> tmp2(tmp);
+            std::vector<double> tmp3(tmp);
+            CLRS::bucketSort(tmp.begin(), tmp.end());
+            CLRS::bucketSort(tmp2.begin(), tmp2.end(), 4);
+            std::sort(tmp3.begin(), tmp3.end());
+            util.assertSequenceEqual(tmp, tmp3);
+            util.assertSequenceEqual(tmp2, tmp3);
+        }
+        {
+            // skewed latency-like values with many duplicates
+            std::vector<float> tmp(100000);
+            std::exponential_distribution<float> dist(0.01f);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return std::round(dist(gen)); });
+            std::vector<float> tmp2(tmp);
+            CLRS::bucketSort(tmp.begin(), tmp.end(), 3);
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // heavy duplicates: 99% zeros, 0.5% of another heavy key, 0.5% random values
+            std::vector<long long> tmp(1000000, 0);
+            std::uniform_int_distribution<int> pick(0, 199);
+            std::uniform_int_distribution<long long> dist(-1000000000, 1000000000);
+            for (auto& value : tmp)
+            {
+                int p = pick(gen);
+                value = p == 0 ? dist(gen) : (p == 1 ? 42 : 0);
+            }
+            std::vector<long long> tmp2(tmp);
+            std::vector<long long> tmp3(tmp);
+            CLRS::bucketSort(tmp.begin(), tmp.end());
+            CLRS::bucketSort(tmp2.begin(), tmp2.end(), 4);
+            std::sort(tmp3.begin(), tmp3.end());
+            util.assertSequenceEqual(tmp, tmp3);
+            util.assertSequenceEqual(tmp2, tmp3);
+        }
+        {
+            // few distinct values and infinities
+            std::vector<double> tmp(100000);
+            std::uniform_int_distribution<int> dist(0, 9);
+            std::generate(tmp.begin(), tmp.end(), [&]() { return dist(gen) * 0.25; });
+            std::vector<double> tmp2(tmp);
+            CLRS::bucketSort(tmp.begin(), tmp.end());
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+            tmp[100] = std::numeric_limits<double>::infinity();
+            tmp[200] = -std::numeric_limits<double>::infinity();
+            tmp2 = tmp;
+            CLRS::bucketSort(tmp.begin(), tmp.end(), 2);
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+    }
+    {
+        // MSD radix sort for strings
+        {
+            std::vector<std::string> tmp;
+            tmp.reserve(vec.size() * 2);
+            std::transform(vec.begin(), vec.end(), std::back_inserter(tmp), [](int val) -> std::string { return std::to_string(val); });
+            std::copy(tmp.begin(), tmp.end(), std::back_inserter(tmp));
+            std::vector<std::string> tmp2(tmp);
+            CLRS::msdRadixSort(tmp.begin(), tmp.end());
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            // long shared prefixes, empty strings, non-ASCII chars
+            std::vector<std::string> tmp{"", ""};
+            std::mt19937 gen;
+            std::uniform_int_distribution<int> dist(0, 255);
+            for (int i = 0; i < 20000; ++i)
+            {
+                std::string str = "https://example.com/logs/" + std::string(i % 7, 'a');
+                for (int j = i % 13; j > 0; --j)
+                {
+                    str.push_back(static_cast<char>(dist(gen) % 4 == 0 ? dist(gen) : 'a' + dist(gen) % 3));
+                }
+                tmp.push_back(std::move(str));
+            }
+            std::vector<std::string> tmp2(tmp);
+            CLRS::msdRadixSort(tmp.begin(), tmp.end());
+            std::sort(tmp2.begin(), tmp2.end());
+            util.assertSequenceEqual(tmp, tmp2);
+        }
+        {
+            std::vector<std::string_view> tmp{"banana", "apple", "", "app", "apple", "b", "apricot"};
+            CLRS::msdRadixSort(tmp.begin(), tmp.end());
+            util.assertSequenceEqual(tmp, std::vector<std::string_view>{"", "app", "apple", "apple", "apricot", "b", "banana"});
+        }
+    }
+    {
+        // external merge sort
+        struct Record
+        {
+            std::uint64_t key;
+            std::uint32_t payload;
+        };
+        auto byKey = [](const Record& a, const Record& b) { return a.key < b.key; };
+        auto directory = std::filesystem::temp_directory_path();
+        auto input = directory / "clrs_test_external_sort_input.bin";
+        auto output = directory / "clrs_test_external_sort_output.bin";
+        auto writeRecords = [&](const std::vector<Record>& records) {
+            std::ofstream file(input, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+        };
+        auto readRecords = [&]() {
+            std::vector<Record> records(std::filesystem::file_size(output) / sizeof(Record));
+            std::ifstream file(output, std::ios::binary);
+            file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+            return records;
+        };
+        auto keys = [](const std::vector<Record>& records) {
+            std::vector<std::uint64_t> res;
+            std::transform(records.begin(), records.end(), std::back_inserter(res), [](const Record& r) { return r.key; });
+            return res;
+        };
+        std::vector<Record> records(100000);
+        std::mt19937_64 gen;
+        for (std::uint32_t i = 0; i < records.size(); ++i)
+        {
+            records[i] = {gen() % 50000, i};
+        }
+        auto sorted = records;
+        std::stable_sort(sorted.begin(), sorted.end(), byKey);
+        writeRecords(records);
+        {
+            // fits in memory: one run
+            CLRS::externalSort<Record>(input, output, byKey);
+            auto result = readRecords();
+            util.assertSequenceEqual(keys(result), keys(sorted));
+        }
+        for (std::size_t threadCount : {1, 2})
+        {
+            // fan-in of 7 with 512 records a merge buffer, so 3584 records a run: 28 runs and 4 intermediate merges.
+            // with 2 threads a run shares the memory with the scratch buffer and bucket indexes of sample sort,
+            // 1737 records a run: 58 runs and 9 intermediate merges.
+            CLRS::ExternalSortOptions options;
+            options.memoryBudget = 4096 * sizeof(Record);
+            options.minBufferSize = 512 * sizeof(Record);
+            options.tempDirectory = directory;
+            options.threadCount = threadCount;
+            CLRS::externalSort<Record>(input, output, byKey, options);
+            auto result = readRecords();
+            util.assertSequenceEqual(keys(result), keys(sorted));
+            // payloads are kept with their keys
+            std::uint64_t sum = 0;
+            for (const auto& record : result)
+            {
+                sum += record.payload * record.key;
+            }
+            std::uint64_t expected = 0;
+            for (const auto& record : records)
+            {
+                expected += record.payload * record.key;
+            }
+            util.assertEqual(sum, expected);
+        }
+        {
+            // empty input
+            writeRecords({});
+            CLRS::externalSort<Record>(input, output, byKey);
+            util.assertEqual(std::filesystem::file_size(output), std::uintmax_t(0));
+        }
+        // no temporary run files are left
+        bool leftover = std::ranges::any_of(std::filesystem::directory_iterator(directory), [](const auto& entry) {
+            return entry.path().filename().string().starts_with("clrs_external_sort_");
+        });
+        util.assertEqual(leftover, false);
+        std::filesystem::remove(input);
+        std::filesystem::remove(output);
+    }
     {
         
     }
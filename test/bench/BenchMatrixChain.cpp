@@ -0,0 +1,101 @@
+// benchmark of the matrix chain order algorithms in DP.hpp: cubic dynamic programming and Hu-Shing polygon partitioning
+// output is CSV on stdout: algorithm,size,ms,cost
+// size is the number of matrices of random dimensions in [1, 1000], time is the best of several rounds,
+// the cubic algorithms are only run up to a few thousands of matrices, their costs are checked against Hu-Shing's one.
+// options (others are ignored, so the options of the other benchmarks could be passed):
+//   -min N       smallest size, default 10
+//   -max N       largest size, default 1000000, sizes are powers of 10
+//   -threads P   thread count of parallel algorithms, default hardware concurrency
+//   -algo S      only algorithms whose name contains S
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <cstdlib>
+#include <DP.hpp>
+
+using Dimensions = std::vector<long long>;
+
+struct Algorithm
+{
+    std::string name;
+    std::size_t maxSize;
+    std::function<long long(const Dimensions&)> minimumCost;
+};
+
+std::size_t threadCount = CLRS::Impl::defaultThreadCount();
+
+std::vector<Algorithm> algorithms = {
+    {"minimumMatrixChainOrder", 2000, [](const Dimensions& p) {
+        auto [m, s] = CLRS::minimumMatrixChainOrder(p.begin(), p.end());
+        return m[0][p.size()-2];
+    }},
+    {"parallelMinimumMatrixChainOrder", 5000, [](const Dimensions& p) {
+        auto [m, s] = CLRS::parallelMinimumMatrixChainOrder(p.begin(), p.end(), threadCount);
+        return m[0][p.size()-2];
+    }},
+    {"huShingMatrixChainOrder", std::numeric_limits<std::size_t>::max(), [](const Dimensions& p) {
+        return CLRS::huShingMatrixChainOrder(p.begin(), p.end()).first;
+    }},
+};
+
+// best time of rounds in milliseconds, slow runs are not repeated
+double measure(const std::function<long long(const Dimensions&)>& minimumCost, const Dimensions& dims, long long& cost)
+{
+    constexpr double slowTime = 1000;
+    double best = std::numeric_limits<double>::max();
+    for (int round = 0; round < 3; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        cost = minimumCost(dims);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        if (best >= slowTime)
+            break;
+    }
+    return best;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::size_t minSize = 10, maxSize = 1000000;
+    std::string algoFilter;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (option == "-min")
+            minSize = std::strtoull(argv[i+1], nullptr, 10);
+        else if (option == "-max")
+            maxSize = std::strtoull(argv[i+1], nullptr, 10);
+        else if (option == "-threads")
+            threadCount = std::max<std::size_t>(1, std::strtoull(argv[i+1], nullptr, 10));
+        else if (option == "-algo")
+            algoFilter = argv[i+1];
+    }
+    std::cout << std::setprecision(4);
+    std::cout << "algorithm,size,ms,cost" << std::endl;
+    std::mt19937_64 gen(2024);
+    std::uniform_int_distribution<long long> dimension(1, 1000);
+    for (std::size_t N = std::max<std::size_t>(minSize, 1); N <= maxSize; N *= 10)
+    {
+        Dimensions dims(N + 1);
+        std::generate(dims.begin(), dims.end(), [&]() { return dimension(gen); });
+        long long expected = CLRS::huShingMatrixChainOrder(dims.begin(), dims.end()).first;
+        for (const auto& algo : algorithms)
+        {
+            if (algo.name.find(algoFilter) == std::string::npos || N > algo.maxSize)
+                continue;
+            long long cost = 0;
+            double ms = measure(algo.minimumCost, dims, cost);
+            std::cout << algo.name << "," << N << "," << ms << "," << cost << std::endl;
+            if (cost != expected)
+                std::cerr << "error: " << algo.name << " cost " << cost << " differs from " << expected << " of size " << N << std::endl;
+        }
+    }
+    return 0;
+}
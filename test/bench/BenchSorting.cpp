@@ -0,0 +1,320 @@
+// benchmark of the sorting algorithms in Sorting.hpp and std::sort/std::stable_sort baselines
+// output is CSV on stdout: algorithm,distribution,size,ns_per_element,comparisons_per_element,moves_per_element
+// time is the best of several rounds on plain values, comparisons and moves (including copies) are counted in a separate run on
+// instrumented values (Instrumentation.hpp), and left empty when the algorithm could not take instrumented values or the size is too large.
+// note: instrumented values are not arithmetic, so small ranges are not sorted by sorting networks in that run.
+// once a sort of one algorithm on one distribution takes longer than slowTime, larger sizes of them are skipped.
+// options:
+//   -min N       smallest size, default 10
+//   -max N       largest size, default 10000000, sizes are powers of 10
+//   -count N     largest size of the counting run, default 1000000
+//   -threads P   thread count of parallel algorithms, default hardware concurrency
+//   -algo S      only algorithms whose name contains S
+//   -dist S      only distributions whose name contains S
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <numeric>
+#include <limits>
+#include <iterator>
+#include <cstdint>
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <concepts>
+#include <type_traits>
+#include <Instrumentation.hpp>
+#include <Sorting.hpp>
+
+template<typename T>
+using Counted = CLRS::BasicInstrumented<T>;
+
+template<typename T>
+const T& keyOf(const T& value)
+{
+    return value;
+}
+template<typename T>
+const T& keyOf(const Counted<T>& value)
+{
+    return value.value;
+}
+
+using IntVector = std::vector<int>;
+using CountedIntVector = std::vector<Counted<int>>;
+using StringVector = std::vector<std::string>;
+using CountedStringVector = std::vector<Counted<std::string>>;
+
+template<typename Iterator>
+using KeyType = std::remove_cvref_t<decltype(keyOf(std::declval<std::iter_value_t<Iterator>&>()))>;
+
+std::size_t threadCount = CLRS::Impl::defaultThreadCount();
+
+// time of one sort in nanoseconds, above which larger sizes of the same algorithm and distribution are skipped
+constexpr double slowTime = 2e9;
+
+// an algorithm sorts any of the four vector types it could be invoked with
+struct Algorithm
+{
+    std::string name;
+    std::size_t maxSize;
+    std::function<void(IntVector&)> sortInts;
+    std::function<void(CountedIntVector&)> sortCountedInts;
+    std::function<void(StringVector&)> sortStrings;
+    std::function<void(CountedStringVector&)> sortCountedStrings;
+};
+
+template<typename Vector, typename Function>
+std::function<void(Vector&)> bindIfInvocable(Function func)
+{
+    if constexpr (std::invocable<Function&, typename Vector::iterator, typename Vector::iterator>)
+        return [func](Vector& vec) mutable { func(vec.begin(), vec.end()); };
+    else
+        return nullptr;
+}
+
+template<typename Function>
+Algorithm makeAlgorithm(std::string name, Function func, std::size_t maxSize = std::numeric_limits<std::size_t>::max())
+{
+    return Algorithm{std::move(name), maxSize,
+        bindIfInvocable<IntVector>(func), bindIfInvocable<CountedIntVector>(func),
+        bindIfInvocable<StringVector>(func), bindIfInvocable<CountedStringVector>(func)};
+}
+
+std::vector<Algorithm> allAlgorithms()
+{
+    std::vector<Algorithm> res;
+    res.push_back(makeAlgorithm("std::sort", [](auto first, auto last) { std::sort(first, last); }));
+    res.push_back(makeAlgorithm("std::stable_sort", [](auto first, auto last) { std::stable_sort(first, last); }));
+    res.push_back(makeAlgorithm("insertionSort", [](auto first, auto last) { CLRS::insertionSort(first, last); }, 20000));
+    res.push_back(makeAlgorithm("mergeSort", [](auto first, auto last) { CLRS::mergeSort(first, last); }));
+    res.push_back(makeAlgorithm("parallelMergeSort", [](auto first, auto last) { CLRS::parallelMergeSort(first, last, std::less<>(), threadCount); }));
+    res.push_back(makeAlgorithm("timSort", [](auto first, auto last) { CLRS::timSort(first, last); }));
+    res.push_back(makeAlgorithm("quickSort", [](auto first, auto last) { CLRS::quickSort(first, last); }));
+    res.push_back(makeAlgorithm("heapSort", [](auto first, auto last) { CLRS::heapSort(first, last); }));
+    res.push_back(makeAlgorithm("parallelSampleSort", [](auto first, auto last) { CLRS::parallelSampleSort(first, last, std::less<>(), threadCount); }));
+    res.push_back(makeAlgorithm("indirectSort", [](auto first, auto last) { CLRS::indirectSort(first, last); }));
+    auto counting = []<typename Iterator>(Iterator first, Iterator last) requires std::integral<KeyType<Iterator>> {
+        if (first == last)
+            return;
+        auto [minIter, maxIter] = std::minmax_element(first, last, [](const auto& a, const auto& b) { return keyOf(a) < keyOf(b); });
+        CLRS::countingSort(first, last, keyOf(*minIter), keyOf(*maxIter), [](const auto& value) { return keyOf(value); });
+    };
+    res.push_back(makeAlgorithm("countingSort", counting));
+    res.push_back(makeAlgorithm("radixSort", []<typename Iterator>(Iterator first, Iterator last) requires std::integral<KeyType<Iterator>> {
+        CLRS::radixSort(first, last, [](const auto& value) { return keyOf(value); });
+    }));
+    res.push_back(makeAlgorithm("parallelRadixSort", []<typename Iterator>(Iterator first, Iterator last) requires std::integral<KeyType<Iterator>> {
+        CLRS::radixSort(first, last, [](const auto& value) { return keyOf(value); }, threadCount);
+    }));
+    res.push_back(makeAlgorithm("bucketSort", []<typename Iterator>(Iterator first, Iterator last) requires std::is_arithmetic_v<std::iter_value_t<Iterator>> {
+        CLRS::bucketSort(first, last);
+    }));
+    res.push_back(makeAlgorithm("msdRadixSort", []<typename Iterator>(Iterator first, Iterator last) requires std::same_as<std::iter_value_t<Iterator>, std::string> {
+        CLRS::msdRadixSort(first, last);
+    }));
+    return res;
+}
+
+// input distributions of ints, values are in [0, 2^30)
+IntVector generateInts(const std::string& dist, std::size_t N, std::mt19937_64& gen)
+{
+    IntVector res(N);
+    if (dist == "random")
+    {
+        std::uniform_int_distribution<int> uniform(0, (1 << 30) - 1);
+        for (auto& val : res)
+            val = uniform(gen);
+    }
+    else if (dist == "sorted")
+    {
+        std::iota(res.begin(), res.end(), 0);
+    }
+    else if (dist == "reverse")
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            res[i] = static_cast<int>(N - i);
+    }
+    else if (dist == "organpipe")
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            res[i] = static_cast<int>(std::min(i, N - i));
+    }
+    else if (dist == "fewunique")
+    {
+        std::uniform_int_distribution<int> uniform(0, 15);
+        for (auto& val : res)
+            val = uniform(gen);
+    }
+    else if (dist == "zipf")
+    {
+        // zipf distribution of exponent 1 over M values by inverse of the cumulative distribution
+        std::size_t M = std::min<std::size_t>(N, std::size_t(1) << 20);
+        std::vector<double> cdf(M);
+        double sum = 0;
+        for (std::size_t i = 0; i < M; ++i)
+        {
+            sum += 1.0 / static_cast<double>(i + 1);
+            cdf[i] = sum;
+        }
+        std::uniform_real_distribution<double> uniform(0, sum);
+        for (auto& val : res)
+            val = static_cast<int>(std::min<std::size_t>(std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin(), M - 1));
+    }
+    return res;
+}
+
+// random lower case strings of 4 to 20 chars
+StringVector generateStrings(std::size_t N, std::mt19937_64& gen)
+{
+    StringVector res(N);
+    std::uniform_int_distribution<std::size_t> length(4, 20);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    for (auto& str : res)
+    {
+        str.resize(length(gen));
+        for (auto& ch : str)
+            ch = static_cast<char>(letter(gen));
+    }
+    return res;
+}
+
+// best time of rounds in nanoseconds per element, fast sorts of small inputs are repeated on a batch of copies,
+// so that a round takes about 20 ms, the first round also estimates the time of one sort.
+template<typename Vector>
+double measure(const std::function<void(Vector&)>& sort, const Vector& input, bool& sorted)
+{
+    constexpr std::size_t batchElements = std::size_t(1) << 20;
+    constexpr double roundTime = 2e7;
+    std::size_t N = input.size();
+    std::size_t reps = 1;
+    int rounds = N >= 10000000 ? 1 : 3;
+    double best = std::numeric_limits<double>::max();
+    for (int round = 0; round <= rounds; ++round)
+    {
+        std::vector<Vector> batch(reps, input);
+        auto start = std::chrono::steady_clock::now();
+        for (auto& vec : batch)
+            sort(vec);
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+        sorted = sorted && std::is_sorted(batch.back().begin(), batch.back().end());
+        if (round == 0)
+        {
+            if (rounds == 1)
+                return elapsed / static_cast<double>(N);
+            reps = std::clamp<std::size_t>(static_cast<std::size_t>(roundTime / std::max(elapsed, 1.0)), 1, std::max<std::size_t>(1, batchElements / N));
+            continue;
+        }
+        best = std::min(best, elapsed / static_cast<double>(N * reps));
+    }
+    return best;
+}
+
+// comparisons and moves per element
+template<typename Vector, typename Input>
+std::pair<double, double> count(const std::function<void(Vector&)>& sort, const Input& input)
+{
+    Vector vec(input.begin(), input.end());
+    CLRS::resetInstrumentationStats();
+    sort(vec);
+    auto stats = CLRS::instrumentationStats();
+    double N = static_cast<double>(input.size());
+    return {static_cast<double>(stats.comparisons) / N, static_cast<double>(stats.copies + stats.moves) / N};
+}
+
+// returns whether the sort was slower than slowTime
+template<typename Vector, typename CountedVector>
+bool run(const Algorithm& algo, const std::string& dist, const Vector& input,
+    const std::function<void(Vector&)>& sort, const std::function<void(CountedVector&)>& sortCounted, std::size_t countMaxSize)
+{
+    if (!sort || input.size() > algo.maxSize)
+        return false;
+    if constexpr (std::integral<typename Vector::value_type>)
+    {
+        // the histogram of counting sort is as large as the key range
+        auto [minIter, maxIter] = std::minmax_element(input.begin(), input.end());
+        if (algo.name == "countingSort" && *maxIter - *minIter > (1 << 24))
+            return false;
+    }
+    bool sorted = true;
+    double ns = measure(sort, input, sorted);
+    std::cout << algo.name << "," << dist << "," << input.size() << "," << ns << ",";
+    if (sortCounted && input.size() <= countMaxSize)
+    {
+        auto [comparisons, moves] = count(sortCounted, input);
+        std::cout << comparisons << "," << moves;
+    }
+    else
+    {
+        std::cout << ",";
+    }
+    std::cout << std::endl;
+    if (!sorted)
+        std::cerr << "error: " << algo.name << " did not sort " << dist << " of size " << input.size() << std::endl;
+    return ns * static_cast<double>(input.size()) > slowTime;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::size_t minSize = 10, maxSize = 10000000, countMaxSize = 1000000;
+    std::string algoFilter, distFilter;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (option == "-min")
+            minSize = std::strtoull(argv[i+1], nullptr, 10);
+        else if (option == "-max")
+            maxSize = std::strtoull(argv[i+1], nullptr, 10);
+        else if (option == "-count")
+            countMaxSize = std::strtoull(argv[i+1], nullptr, 10);
+        else if (option == "-threads")
+            threadCount = std::max<std::size_t>(1, std::strtoull(argv[i+1], nullptr, 10));
+        else if (option == "-algo")
+            algoFilter = argv[i+1];
+        else if (option == "-dist")
+            distFilter = argv[i+1];
+    }
+    auto algorithms = allAlgorithms();
+    std::cout << std::setprecision(4);
+    std::cout << "algorithm,distribution,size,ns_per_element,comparisons_per_element,moves_per_element" << std::endl;
+    std::mt19937_64 gen(20231016);
+    std::set<std::pair<std::string, std::string>> slow; // (algorithm, distribution) that are skipped
+    for (std::size_t N = std::max<std::size_t>(minSize, 1); N <= maxSize; N *= 10)
+    {
+        for (std::string dist : {"random", "sorted", "reverse", "organpipe", "fewunique", "zipf", "strings"})
+        {
+            if (dist.find(distFilter) == std::string::npos)
+                continue;
+            if (dist == "strings")
+            {
+                // strings take about 10 times the memory of ints
+                if (N > std::max<std::size_t>(maxSize / 10, 10))
+                    continue;
+                auto input = generateStrings(N, gen);
+                for (const auto& algo : algorithms)
+                {
+                    if (algo.name.find(algoFilter) != std::string::npos && !slow.contains({algo.name, dist})
+                        && run(algo, dist, input, algo.sortStrings, algo.sortCountedStrings, countMaxSize))
+                        slow.emplace(algo.name, dist);
+                }
+            }
+            else
+            {
+                auto input = generateInts(dist, N, gen);
+                for (const auto& algo : algorithms)
+                {
+                    if (algo.name.find(algoFilter) != std::string::npos && !slow.contains({algo.name, dist})
+                        && run(algo, dist, input, algo.sortInts, algo.sortCountedInts, countMaxSize))
+                        slow.emplace(algo.name, dist);
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+// counting of global allocations by replaced operator new and operator delete,
+// an executable of its own, so that other tests keep the allocation functions of the standard library.
+#include "../TestUtil.hpp"
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <functional>
+#define CLRS_INSTRUMENTATION_REPLACE_NEW
+#include <Instrumentation.hpp>
+#include <Sorting.hpp>
+#include <Tree.hpp>
+
+struct alignas(128) OverAligned
+{
+    char bytes[128];
+};
+
+void testReplaceNew(DetailFlag detail)
+{
+    TestUtil util(detail, "replace new");
+    {
+        // every form of new and delete
+        CLRS::resetInstrumentationStats();
+        int* p = new int(1);
+        delete p;
+        int* arr = new int[100];
+        delete[] arr;
+        int* q = new (std::nothrow) int(2);
+        ::operator delete(q, std::nothrow);
+        int* qarr = new (std::nothrow) int[10];
+        delete[] qarr;
+        auto stats = CLRS::instrumentationStats();
+        util.assertEqual(stats.allocations, std::uint64_t(4));
+        util.assertEqual(stats.deallocations, std::uint64_t(4));
+        util.assertEqual(stats.allocatedBytes >= (1 + 100 + 1 + 10) * sizeof(int), true);
+    }
+    {
+        // over-aligned allocations
+        CLRS::resetInstrumentationStats();
+        auto* a = new OverAligned;
+        auto* b = new OverAligned[3];
+        auto* c = new (std::nothrow) OverAligned;
+        util.assertEqual(reinterpret_cast<std::uintptr_t>(a) % alignof(OverAligned), std::uintptr_t(0));
+        util.assertEqual(reinterpret_cast<std::uintptr_t>(b) % alignof(OverAligned), std::uintptr_t(0));
+        util.assertEqual(reinterpret_cast<std::uintptr_t>(c) % alignof(OverAligned), std::uintptr_t(0));
+        delete a;
+        delete[] b;
+        delete c;
+        {
+            std::vector<OverAligned> vec(5);
+            util.assertEqual(reinterpret_cast<std::uintptr_t>(vec.data()) % alignof(OverAligned), std::uintptr_t(0));
+        }
+        auto stats = CLRS::instrumentationStats();
+        util.assertEqual(stats.allocations, std::uint64_t(4));
+        util.assertEqual(stats.deallocations, std::uint64_t(4));
+        util.assertEqual(stats.allocatedBytes, std::uint64_t((1 + 3 + 1 + 5) * sizeof(OverAligned)));
+    }
+    {
+        // containers are counted by both the counting allocator and the global operator new
+        CLRS::resetInstrumentationStats();
+        {
+            std::vector<int, CLRS::BasicCountingAllocator<int>> tmp;
+            tmp.reserve(1000);
+            auto stats = CLRS::instrumentationStats();
+            util.assertEqual(stats.allocations, std::uint64_t(2));
+            util.assertEqual(stats.allocatedBytes >= 2 * 1000 * sizeof(int), true);
+        }
+        util.assertEqual(CLRS::instrumentationStats().deallocations, std::uint64_t(2));
+    }
+    {
+        // every allocation of an algorithm or a container is freed
+        std::vector<int> vec(1000);
+        std::iota(vec.begin(), vec.end(), 0);
+        std::shuffle(vec.begin(), vec.end(), std::mt19937());
+        CLRS::resetInstrumentationStats();
+        CLRS::mergeSort(vec.begin(), vec.end());
+        auto stats = CLRS::instrumentationStats();
+        util.assertSorted(vec.begin(), vec.end());
+        util.assertEqual(stats.allocations, stats.deallocations);
+        std::shuffle(vec.begin(), vec.end(), std::mt19937());
+        CLRS::resetInstrumentationStats();
+        {
+            CLRS::BsTree<int, int, std::identity> tree;
+            for (int val : vec)
+                tree.insert(val);
+            util.assertEqual(tree.size(), std::size_t(1000));
+            util.assertEqual(CLRS::instrumentationStats().allocations >= 1000, true);
+        }
+        stats = CLRS::instrumentationStats();
+        util.assertEqual(stats.allocations, stats.deallocations);
+    }
+    util.showFinalResult();
+}
+
+int main(int argc, char const *argv[])
+{
+    auto detail = parseDetailFlag(argc, argv);
+    testReplaceNew(detail);
+    return 0;
+}
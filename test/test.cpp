@@ -17,6 +17,7 @@ void testFFT(DetailFlag detail);
 void testNumberTheory(DetailFlag detail);
 void testString(DetailFlag detail);
 void testGeometry(DetailFlag detail);
+void testInstrumentation(DetailFlag detail);
 
 int main(int argc, char const *argv[])
 {
@@ -34,5 +35,6 @@ int main(int argc, char const *argv[])
     testNumberTheory(detail);
     testString(detail);
     testGeometry(detail);
+    testInstrumentation(detail);
     return 0;
 }